@@ -0,0 +1,135 @@
+#include "Archetype.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+std::map<Archetype::Signature, Archetype*> Archetype::archetypes;
+std::vector<Archetype*> Archetype::list;
+
+Archetype::Archetype(const Signature& _signature):
+	signature(_signature),
+	capacity(std::max<unsigned>(1, CHUNK_SIZE / ((_signature.size() + 1) * sizeof(void*)))),
+	size(0), reserved(0)
+{
+	if (!signature.empty())
+	{
+		columns.resize(signature.back() + 1);
+		counts.resize(signature.back() + 1);
+	}
+
+	for (unsigned i(signature.size()) ; i-- > 0 ; )
+	{
+		mask.set(signature[i]);
+		columns[signature[i]] = i;
+		counts[signature[i]]++;
+	}
+}
+
+Archetype::~Archetype()
+{
+	for (void* chunk: chunks)
+		free(chunk);
+}
+
+/// Methods (static)
+Archetype* Archetype::get(const Signature& _signature)
+{
+	auto it = archetypes.find(_signature);
+	if (it != archetypes.end())
+		return it->second;
+
+	Archetype* archetype = new Archetype(_signature);
+	archetypes.emplace(_signature, archetype);
+	list.push_back(archetype);
+
+	return archetype;
+}
+
+Archetype* Archetype::empty()
+{
+	static const Signature none;
+	return get(none);
+}
+
+void Archetype::clear()
+{
+	for (Archetype* archetype: list)
+		delete archetype;
+
+	archetypes.clear();
+	list.clear();
+}
+
+/// Methods (public)
+Archetype* Archetype::with(unsigned _type)
+{
+	if (_type >= added.size())
+		added.resize(_type + 1, nullptr);
+
+	if (added[_type] == nullptr)
+	{
+		Signature s(signature);
+		s.insert(std::upper_bound(s.begin(), s.end(), _type), _type);
+
+		added[_type] = get(s);
+	}
+
+	return added[_type];
+}
+
+Archetype* Archetype::without(unsigned _type)
+{
+	if (_type >= removed.size())
+		removed.resize(_type + 1, nullptr);
+
+	if (removed[_type] == nullptr)
+	{
+		Signature s(signature);
+		s.erase(std::lower_bound(s.begin(), s.end(), _type));
+
+		removed[_type] = get(s);
+	}
+
+	return removed[_type];
+}
+
+unsigned Archetype::insert(Entity* _entity)
+{
+	if (size == chunks.size() * capacity)
+		chunks.push_back(malloc((signature.size() + 1) * capacity * sizeof(void*)));
+
+	unsigned row = size++;
+	entity(row) = _entity;
+
+	return row;
+}
+
+void Archetype::reserve(unsigned _rows)
+{
+	reserved = std::max(reserved, size + _rows);
+	while (chunks.size() * capacity < size + _rows)
+		chunks.push_back(malloc((signature.size() + 1) * capacity * sizeof(void*)));
+}
+
+Entity* Archetype::remove(unsigned _row)
+{
+	unsigned last = --size;
+
+	Entity* moved = nullptr;
+	if (_row != last)
+	{
+		moved = entity(_row) = entity(last);
+		for (unsigned i(0); i < signature.size(); i++)
+			component(_row, i) = component(last, i);
+	}
+
+	// Keep one spare chunk to avoid reallocating around a boundary
+	unsigned kept = std::max(size + capacity, reserved);
+	if (chunks.size() > 1 && kept + capacity <= chunks.size() * capacity)
+	{
+		free(chunks.back());
+		chunks.pop_back();
+	}
+
+	return moved;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ComponentType.h"
+
+#include <algorithm>
+#include <bitset>
+#include <vector>
+#include <map>
+
+class Entity;
+class Component;
+
+// Table of the entities sharing the same set of component types
+// A type appears once per component instance in the signature, so that an entity with two colliders
+// has two Collider columns. Rows are stored in fixed size chunks, each chunk holding the entity
+// pointers followed by one contiguous array per column.
+class Archetype
+{
+public:
+	typedef std::vector<unsigned> Signature; // sorted component type ids
+	typedef std::bitset<ComponentType::MAX> Mask;
+
+	static const unsigned npos = ~0u;
+	static const size_t CHUNK_SIZE = 16 * 1024;
+
+	/// Methods (static)
+	static Archetype* get(const Signature& _signature);
+	static Archetype* empty();
+
+	static const std::vector<Archetype*>& all()	{ return list; }
+	static void clear(); // all archetypes must be empty
+
+	/// Methods (public)
+	// Archetype with one more (or one less) component of this type, the transitions are cached
+	Archetype* with(unsigned _type);
+	Archetype* without(unsigned _type);
+
+	// First column holding components of this type, and the number of such columns
+	unsigned find(unsigned _type) const
+	{ return mask[_type] ? columns[_type] : npos; }
+
+	unsigned count(unsigned _type) const
+	{ return mask[_type] ? counts[_type] : 0; }
+
+	unsigned insert(Entity* _entity); // returns the row
+	void reserve(unsigned _rows); // allocate chunks for _rows more rows, kept until clear
+	Entity* remove(unsigned _row); // moves the last row into _row and returns its entity, if any
+
+	/// Getters
+	unsigned getSize() const	{ return size; }
+	unsigned getColumns() const	{ return (unsigned)signature.size(); }
+	const Signature& getSignature() const	{ return signature; }
+	const Mask& getMask() const		{ return mask; }
+
+	Entity*& entity(unsigned _row)
+	{ return entities(_row / capacity)[_row % capacity]; }
+
+	Component*& component(unsigned _row, unsigned _column)
+	{ return column(_row / capacity, _column)[_row % capacity]; }
+
+	// Chunk iteration, every chunk is full except the last one
+	unsigned getChunkCount() const	{ return (size + capacity - 1) / capacity; }
+	unsigned getChunkSize(unsigned _chunk) const
+	{ return std::min(capacity, size - _chunk * capacity); }
+
+	Entity** entities(unsigned _chunk)
+	{ return reinterpret_cast<Entity**>(chunks[_chunk]); }
+
+	Component** column(unsigned _chunk, unsigned _column)
+	{ return reinterpret_cast<Component**>(chunks[_chunk]) + (_column + 1) * capacity; }
+
+private:
+	/// Methods (private)
+	Archetype(const Signature& _signature);
+	~Archetype();
+
+	/// Attributes (private)
+	const Signature signature;
+	const unsigned capacity; // rows per chunk
+
+	Mask mask;
+	std::vector<unsigned> columns, counts; // indexed by type id
+
+	unsigned size, reserved; // reserved: rows that never give their chunks back
+	std::vector<void*> chunks;
+
+	std::vector<Archetype*> added, removed; // indexed by type id
+
+	/// Attributes (static)
+	static std::map<Signature, Archetype*> archetypes;
+	static std::vector<Archetype*> list;
+};
@@ -0,0 +1,103 @@
+#include "ComponentType.h"
+#include "Utility/Error.h"
+
+#include <cstdlib>
+
+/// Methods (public)
+unsigned ComponentType::find(std::type_index _type)
+{
+	std::lock_guard<std::mutex> guard(lock());
+
+	auto it = ids().find(_type);
+	return it != ids().end() ? it->second : npos;
+}
+
+uint32_t ComponentType::tick()
+{
+	return version().fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t ComponentType::changed(unsigned _id)
+{
+	uint32_t current = getVersion();
+	if (_id != npos)
+		versions()[_id].store(current, std::memory_order_relaxed);
+
+	return current;
+}
+
+/// Getters
+uint32_t ComponentType::getVersion(unsigned _id)
+{
+	return versions()[_id].load(std::memory_order_relaxed);
+}
+
+unsigned ComponentType::getCount()
+{
+	std::lock_guard<std::mutex> guard(lock());
+	return (unsigned)types().size();
+}
+
+size_t ComponentType::getSize(unsigned _id)
+{
+	std::lock_guard<std::mutex> guard(lock());
+	return types()[_id].size;
+}
+
+const char* ComponentType::getName(unsigned _id)
+{
+	std::lock_guard<std::mutex> guard(lock());
+	return types()[_id].type.name();
+}
+
+/// Methods (private)
+unsigned ComponentType::add(std::type_index _type, size_t _size)
+{
+	std::lock_guard<std::mutex> guard(lock());
+
+	auto it = ids().find(_type);
+	if (it != ids().end())
+		return it->second;
+
+	unsigned id = (unsigned)types().size();
+	if (id == MAX)
+	{
+		Error::add(Error::MINGE, "Too many component types, increase ComponentType::MAX");
+		exit(EXIT_FAILURE);
+	}
+
+	types().push_back({_type, _size});
+	ids().emplace(_type, id);
+
+	return id;
+}
+
+std::vector<ComponentType::Info>& ComponentType::types()
+{
+	static std::vector<Info> types;
+	return types;
+}
+
+std::unordered_map<std::type_index, unsigned>& ComponentType::ids()
+{
+	static std::unordered_map<std::type_index, unsigned> ids;
+	return ids;
+}
+
+std::mutex& ComponentType::lock()
+{
+	static std::mutex lock;
+	return lock;
+}
+
+std::atomic<uint32_t>& ComponentType::version()
+{
+	static std::atomic<uint32_t> version(1); // readers start at 0
+	return version;
+}
+
+std::atomic<uint32_t>* ComponentType::versions()
+{
+	static std::atomic<uint32_t> versions[MAX] = {};
+	return versions;
+}
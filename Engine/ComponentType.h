@@ -0,0 +1,57 @@
+#pragma once
+
+#include <unordered_map>
+#include <typeindex>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <mutex>
+
+// Dense component type ids, assigned on first use of each type
+// The registry also maps runtime types back to their id, and keeps the size of each type
+// so that scripts, which have no cloneInto(), can be copied.
+class ComponentType
+{
+public:
+	static const unsigned MAX = 256;
+	static const unsigned npos = ~0u;
+
+	template <typename T>
+	static unsigned id()
+	{
+		static const unsigned value = add(typeid(T), sizeof(T));
+		return value;
+	}
+
+	static unsigned find(std::type_index _type); // npos if the type never got an id
+
+	// Change versions: components are stamped with the current version when they change
+	// A reader remembers the value returned by tick() and looks for versions greater than that
+	static uint32_t tick(); // returns the current version and starts a new one
+	static uint32_t changed(unsigned _id); // returns the current version
+
+	static uint32_t getVersion()	{ return version().load(std::memory_order_relaxed); }
+	static uint32_t getVersion(unsigned _id); // last change of a component of this type
+
+	/// Getters
+	static unsigned getCount();
+	static size_t getSize(unsigned _id);
+	static const char* getName(unsigned _id);
+
+private:
+	struct Info
+	{
+		std::type_index type;
+		size_t size;
+	};
+
+	static unsigned add(std::type_index _type, size_t _size);
+
+	// Function statics, ids can be requested during static initialization
+	static std::vector<Info>& types();
+	static std::unordered_map<std::type_index, unsigned>& ids();
+	static std::mutex& lock();
+
+	static std::atomic<uint32_t>& version();
+	static std::atomic<uint32_t>* versions(); // indexed by id
+};
@@ -29,9 +29,9 @@ Animator::~Animator()
 }
 
 /// Methods (public)
-Animator* Animator::clone() const
+Animator* Animator::cloneInto(void* _slot) const
 {
-	return new Animator(skeleton);
+	return new (_slot) Animator(skeleton);
 }
 
 void Animator::setMotion(vec2 _pos)
@@ -60,11 +60,14 @@ void Animator::setMotion(vec2 _pos)
 		motion.weight *= scale;
 }
 
-void Animator::animate()
+void Animator::sample()
 {
 	for (auto &motion : blender.motions)
 		motion.update();
+}
 
+void Animator::animate()
+{
 	for (size_t i = 0; i < skeleton.offsets.size(); i++)
 	{
 		bones[i]->position = vec3(0.0f);
@@ -150,6 +153,16 @@ void Animator::onRegister()
 	GraphicEngine::get()->addAnimator(this);
 }
 
+void Animator::onDeregister()
+{
+	GraphicEngine::get()->removeAnimator(this);
+}
+
+void Animator::onReserve(unsigned _count) const
+{
+	GraphicEngine::get()->reserveAnimators(_count);
+}
+
 void Animator::upload()
 {
 	tr->toMatrix(); // Updates all hierarchy
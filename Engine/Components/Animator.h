@@ -44,15 +44,18 @@ struct MotionBlender
 
 class Animator : public Component
 {
+	friend class GraphicEngine;
+
 public:
 	Animator(Skeleton _skeleton);
 	virtual ~Animator();
 
 	/// Methods (public)
-	virtual Animator* clone() const override;
+	virtual Animator* cloneInto(void* _slot) const override;
 
 	void setMotion(vec2 _pos);
-	void animate();
+	void sample();	// advance the motions, only writes the animator
+	void animate();	// pose the bones from the last sample
 
 	/// Getters
 	Transform* getBone(unsigned index) const;
@@ -66,6 +69,8 @@ public:
 private:
 	/// Methods (private)
 	virtual void onRegister() override;
+	virtual void onDeregister() override;
+	virtual void onReserve(unsigned _count) const override;
 	void upload();
 
 	/// Attributes (private)
@@ -75,4 +80,6 @@ private:
 
 	Transform **bones;
 	mat4 *matrices;
+
+	unsigned index = ~0u; // in GraphicEngine::animators
 };
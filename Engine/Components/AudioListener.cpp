@@ -9,9 +9,9 @@ AudioListener::AudioListener()
 AudioListener::~AudioListener()
 { }
 
-AudioListener* AudioListener::clone() const
+AudioListener* AudioListener::cloneInto(void* _slot) const
 {
-	return new AudioListener();
+	return new (_slot) AudioListener();
 }
 
 void AudioListener::update()
@@ -11,7 +11,7 @@ class AudioListener : public Component
 		virtual ~AudioListener();
 
 		/// Methods (public)
-			virtual AudioListener* clone() const override;
+			virtual AudioListener* cloneInto(void* _slot) const override;
 
 			void update();
 
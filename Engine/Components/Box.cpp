@@ -11,9 +11,9 @@ Box::~Box()
 { }
 
 /// Methods (public)
-Box* Box::clone() const
+Box* Box::cloneInto(void* _slot) const
 {
-	return new Box(halfExtent, center, material, isTrigger);
+	return new (_slot) Box(halfExtent, center, material, isTrigger);
 }
 
 void Box::computeMass()
@@ -107,6 +107,7 @@ RayHit Box::raycast(vec3 _o, vec3 _d)
 void Box::setHalfExtent(vec3 _halfExtent)
 {
 	halfExtent = _halfExtent;
+	changed();
 }
 
 /// Getters
@@ -5,12 +5,14 @@
 
 class Box : public Collider
 {
+	friend class Snapshot; // saves the unscaled shape
+
 	public:
 		Box(vec3 _halfExtent = vec3(0.5f), vec3 _center = vec3(0.0f), PhysicMaterialRef _material = NULL, bool _isTrigger = false);
 		virtual ~Box();
 
 		/// Methods (public)
-			virtual Box* clone() const override;
+			virtual Box* cloneInto(void* _slot) const override;
 
 			virtual void computeMass() override;
 			virtual void computeAABB() override;
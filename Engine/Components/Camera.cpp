@@ -19,9 +19,9 @@ Camera::Camera(float _FOV, float _zNear, float _zFar, vec3 _clearColor, RenderTa
 }
 
 /// Methods (public)
-Camera* Camera::clone() const
+Camera* Camera::cloneInto(void* _slot) const
 {
-	return new Camera(FOV, zNear, zFar, clearColor, renderTarget, orthographic, relViewport, clearFlags);
+	return new (_slot) Camera(FOV, zNear, zFar, clearColor, renderTarget, orthographic, relViewport, clearFlags);
 }
 
 /// Getters
@@ -59,6 +59,7 @@ void Camera::onRegister()
 void Camera::onDeregister()
 {
 	GraphicEngine::get()->removeCamera(this);
+	GraphicEngine::get()->retire(renderTarget);
 }
 
 void Camera::update(View *view)
@@ -17,7 +17,7 @@ public:
 		unsigned _priority = 0);
 
 	/// Methods (public)
-	virtual Camera* clone() const override;
+	virtual Camera* cloneInto(void* _slot) const override;
 
 	/// Getters
 	RenderTargetRef getRenderTarget() const;
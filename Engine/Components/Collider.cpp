@@ -55,6 +55,13 @@ vec3 Collider::getCenter() const
 	return center;
 }
 
+/// Setters
+void Collider::setCenter(vec3 _center)
+{
+	center = _center;
+	changed();
+}
+
 /// Methods (private)
 void Collider::onRegister()
 {
@@ -68,6 +75,11 @@ void Collider::onRegister()
 	PhysicEngine::get()->addCollider(this);
 }
 
+void Collider::onReserve(unsigned _count) const
+{
+	PhysicEngine::get()->reserveColliders(_count);
+}
+
 void Collider::onDeregister()
 {
 	if (rigidBody != nullptr)
@@ -18,13 +18,14 @@ class Collider : public Component
 {
 	friend class Entity;
 	friend class RigidBody;
+	friend class PhysicEngine;
 
 	public:
 		Collider(PhysicMaterialRef _material, bool _isTrigger, vec3 _center);
 		virtual ~Collider();
 
 		/// Methods (public)
-			virtual Collider* clone() const = 0;
+			virtual Collider* cloneInto(void* _slot) const = 0;
 
 			virtual void computeMass() = 0;
 			virtual void computeAABB() = 0;
@@ -44,6 +45,9 @@ class Collider : public Component
 
 			virtual vec3 getSupport(vec3 _axis) = 0;
 
+		/// Setters
+			void setCenter(vec3 _center);
+
 		// TODO: make it private
 		/// Attributes (public)
 			RigidBody* rigidBody;
@@ -52,6 +56,7 @@ class Collider : public Component
 		/// Methods (private)
 			virtual void onRegister() override;
 			virtual void onDeregister() override;
+			virtual void onReserve(unsigned _count) const override;
 
 		/// Attributes (protected)
 			PhysicMaterialRef material;
@@ -63,6 +68,9 @@ class Collider : public Component
 
 			AABB aabb;
 
+	private:
+		/// Attributes (private)
+			unsigned index = ~0u; // in PhysicEngine::colliders
 };
 
 #endif // COLLIDER_H
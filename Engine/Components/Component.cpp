@@ -1,11 +1,38 @@
 #include "Components/Component.h"
 
+#include <unordered_map>
+#include <mutex>
+
+namespace
+{
+	const size_t SIZE_CLASS = 16; // granularity of the shared pools
+
+	// Never destroyed, components may be deleted during static destruction
+	std::mutex& poolsLock()
+	{
+		static auto* lock = new std::mutex();
+		return *lock;
+	}
+
+	ObjectPool** typePools()
+	{
+		static auto* pools = new ObjectPool*[ComponentType::MAX]();
+		return pools;
+	}
+
+	std::unordered_map<size_t, ObjectPool*>& sizePools()
+	{
+		static auto* pools = new std::unordered_map<size_t, ObjectPool*>();
+		return *pools;
+	}
+}
+
 #ifdef DEBUG
 int Component::instances = 0;
 #endif
 
 Component::Component():
-	entity(nullptr), tr(nullptr)
+	entity(nullptr), tr(nullptr), type(ComponentType::npos), version(ComponentType::getVersion())
 {
 #ifdef DEBUG
 	instances++;
@@ -18,3 +45,58 @@ Component::~Component()
 	instances--;
 #endif
 }
+
+/// Methods (protected)
+void Component::changed()
+{
+	version = ComponentType::changed(type);
+}
+
+/// Methods (static)
+void* Component::operator new(size_t _size)
+{
+	size_t size = (_size + SIZE_CLASS - 1) / SIZE_CLASS * SIZE_CLASS;
+
+	std::unique_lock<std::mutex> guard(poolsLock());
+	ObjectPool*& pool = sizePools()[size];
+	if (pool == nullptr)
+		pool = new ObjectPool(size);
+	guard.unlock();
+
+	return pool->alloc();
+}
+
+void* Component::operator new(size_t, ObjectPool* _pool)
+{
+	return _pool->alloc();
+}
+
+void* Component::operator new(size_t, void* _slot)
+{
+	return _slot;
+}
+
+void Component::operator delete(void* _data)
+{
+	if (_data)
+		ObjectPool::free(_data);
+}
+
+void Component::operator delete(void* _data, ObjectPool*)
+{
+	ObjectPool::free(_data);
+}
+
+void Component::operator delete(void*, void*)
+{ }
+
+ObjectPool* Component::getPool(unsigned _type, size_t _size)
+{
+	std::lock_guard<std::mutex> guard(poolsLock());
+
+	ObjectPool*& pool = typePools()[_type];
+	if (pool == nullptr)
+		pool = new ObjectPool(_size);
+
+	return pool;
+}
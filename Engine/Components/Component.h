@@ -2,20 +2,48 @@
 #define COMPONENT_H
 
 #include "Entity.h"
+#include "Utility/Memory/ObjectPool.h"
 
 class Component
 {
 	friend class Entity;
+	friend class EntityCommandBuffer;
+	friend class Snapshot;
 
 	public:
 		Component();
 		virtual ~Component();
 
+		// Components inserted with Entity::insert or instantiated get a pool per type,
+		// others are allocated from pools shared by all components of a same size
+		static void* operator new(size_t _size);
+		static void* operator new(size_t _size, ObjectPool* _pool);
+		static void* operator new(size_t _size, void* _slot); // placement, for cloneInto
+		static void operator delete(void* _data);
+		static void operator delete(void* _data, ObjectPool* _pool); // if a constructor throws
+		static void operator delete(void* _data, void* _slot);
+
+		// Calls _func(T*) on every component of type T allocated from its pool, in memory order
+		// Includes the components of prototypes, components must not be created or deleted meanwhile
+		template <typename T, typename F>
+		static void eachInPool(F _func)
+		{
+			getPool(ComponentType::id<T>(), sizeof(T))->each([&](void* _data) {
+				_func(static_cast<T*>(_data));
+			});
+		}
+
+		static ObjectPool* getPool(unsigned _type, size_t _size); // pool of a type, thread safe
+
 		/// Methods (public)
-			virtual Component* clone() const = 0;
+			// Constructs a copy in _slot with new (_slot), the slot has room for an object of the type
+			// Returning nullptr makes a bitwise copy instead, see Entity::instantiate
+			virtual Component* cloneInto(void* _slot) const = 0;
 
 		/// Getters
 			Entity*	getEntity() const	{ return entity; }
+			unsigned getType() const	{ return type; } // ComponentType id
+			uint32_t getVersion() const	{ return version; } // ComponentType version of the last change
 
 			template <typename T> inline bool has() const
 			{
@@ -48,12 +76,20 @@ class Component
 
 	protected:
 		/// Methods (private)
+			void changed(); // to be called when the state seen by other systems changes
+
 			virtual void onRegister() {};
 			virtual void onDeregister() {};
+			virtual void onReserve(unsigned) const {}; // called on one component before that many copies are registered
 
 		/// Attributes (protected)
 			Entity* entity;
 			Transform* tr;
+
+	private:
+		/// Attributes (private)
+			unsigned type;
+			uint32_t version;
 };
 
 #endif // COMPONENT_H
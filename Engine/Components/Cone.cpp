@@ -12,9 +12,9 @@ Cone::~Cone()
 { }
 
 /// Methods (public)
-Cone* Cone::clone() const
+Cone* Cone::cloneInto(void* _slot) const
 {
-	return new Cone(radius, height, center, material, isTrigger);
+	return new (_slot) Cone(radius, height, center, material, isTrigger);
 }
 
 void Cone::computeMass()
@@ -5,12 +5,14 @@
 
 class Cone : public Collider
 {
+	friend class Snapshot; // saves the unscaled shape
+
 	public:
 		Cone(float _radius = 0.5f, float _height = 1.0f, vec3 _center = vec3(0.0f), PhysicMaterialRef _material = NULL, bool _isTrigger = false);
 		virtual ~Cone();
 
 		/// Methods (public)
-			virtual Cone* clone() const override;
+			virtual Cone* cloneInto(void* _slot) const override;
 
 			virtual void computeMass() override;
 			virtual void computeAABB() override;
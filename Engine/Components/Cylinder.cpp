@@ -11,9 +11,9 @@ Cylinder::~Cylinder()
 { }
 
 /// Methods (public)
-Cylinder* Cylinder::clone() const
+Cylinder* Cylinder::cloneInto(void* _slot) const
 {
-	return new Cylinder(radius, height, center, material, isTrigger);
+	return new (_slot) Cylinder(radius, height, center, material, isTrigger);
 }
 
 void Cylinder::computeMass()
@@ -3,9 +3,7 @@
 
 #include "Systems/GraphicEngine.h"
 
-#include "Renderer/RenderContext.inl"
-#include "Renderer/CommandKey.h"
-#include "Renderer/Commands.h"
+#include "Utility/Memory/FrameAllocator.h"
 
 Graphic::Graphic(MeshRef _mesh)
 {
@@ -29,45 +27,26 @@ Graphic::~Graphic()
 { }
 
 /// Methods (public)
-Graphic* Graphic::clone() const
+Graphic* Graphic::cloneInto(void* _slot) const
 {
-	return new Graphic(mesh, materials);
+	return new (_slot) Graphic(mesh, materials);
 }
 
-void Graphic::render(RenderContext *ctx, uint32_t num_views, View const *views) const
+void Graphic::snapshot(Drawable *_drawable)
 {
-	const mat4 &model = tr->getToWorld();
+	_drawable->model = tr->getToWorld();
+	_drawable->position = tr->position;
 
-	unsigned vao = mesh->getVAO();
-	const Submesh *submeshes = mesh->getSubmeshes().data();
+	_drawable->vao = mesh->getVAO();
+	_drawable->submeshes = mesh->getSubmeshes().data();
 
-	std::vector<void*> commands(materials.size());
+	// retire() keeps the mesh and materials alive until the commands are submitted
+	const Material **copy = FrameAllocator::get()->alloc<const Material*>(materials.size());
 	for (size_t i(0); i < materials.size(); i++)
-	{
-		auto *cmd = ctx->create<DrawElements>();
-		commands[i] = cmd;
-
-		cmd->model = model;
-		cmd->vao = vao;
-		memcpy(&(cmd->submesh), submeshes + i, sizeof(Submesh));
-	}
-
-	for (uint32_t view_id(0) ; view_id < num_views; ++view_id)
-	{
-		const View &view = views[view_id];
+		copy[i] = materials[i].get();
 
-		vec4 pos = view.vp * vec4(tr->position, 1.0f);
-		float depth = pos.z / pos.w;
-
-		for (size_t i(0); i < materials.size(); i++)
-		{
-			if (!materials[i]->has_pass(view.pass))
-				continue;
-
-			uint64_t key = CommandKey::encode(view_id, view.pass, materials[i]->get_id(), depth);
-			ctx->add(key, commands[i]);
-		}
-	}
+	_drawable->materials = copy;
+	_drawable->material_count = materials.size();
 }
 
 /// Setters
@@ -151,8 +130,12 @@ void Graphic::updateMesh(MeshRef _mesh)
 		GraphicEngine::get()->removeGraphic(this);
 	else if (!mesh && _mesh)
 		GraphicEngine::get()->addGraphic(this);
+
+	retire();
 	mesh = _mesh;
 	materials.clear();
+
+	changed();
 }
 
 void Graphic::onRegister()
@@ -161,8 +144,28 @@ void Graphic::onRegister()
 		GraphicEngine::get()->addGraphic(this);
 }
 
+void Graphic::onReserve(unsigned _count) const
+{
+	if (mesh)
+		GraphicEngine::get()->reserveGraphics(_count);
+}
+
 void Graphic::onDeregister()
 {
 	if (mesh)
 		GraphicEngine::get()->removeGraphic(this);
+
+	retire();
+}
+
+void Graphic::retire()
+{
+	GraphicEngine *engine = GraphicEngine::get();
+	if (engine == nullptr || mesh == nullptr)
+		return;
+
+	// Commands in flight may still use them
+	engine->retire(mesh);
+	for (const MaterialRef &material: materials)
+		engine->retire(material);
 }
@@ -9,6 +9,8 @@
 
 class Graphic : public Component
 {
+	friend class GraphicEngine;
+
 public:
 	Graphic(MeshRef _mesh);
 	Graphic(MeshRef _mesh, std::vector<MaterialRef> _materials);
@@ -16,9 +18,9 @@ public:
 	virtual ~Graphic();
 
 	/// Methods (public)
-	virtual Graphic* clone() const override;
+	virtual Graphic* cloneInto(void* _slot) const override;
 
-	void render(struct RenderContext *ctx, uint32_t num_views, struct View const *views) const;
+	void snapshot(struct Drawable *_drawable);
 
 	/// Setters
 	void setMesh(MeshRef _mesh);
@@ -35,11 +37,15 @@ public:
 private:
 	/// Methods (private)
 	void updateMesh(MeshRef _mesh);
+	void retire();
 
 	virtual void onRegister() override;
 	virtual void onDeregister() override;
+	virtual void onReserve(unsigned _count) const override;
 
 	/// Attributes
 	MeshRef mesh;
 	std::vector<MaterialRef> materials;
+
+	unsigned index = ~0u; // in GraphicEngine::graphics
 };
@@ -22,9 +22,9 @@ Light::~Light()
 { }
 
 /// Methods (public)
-Light* Light::clone() const
+Light* Light::cloneInto(void* _slot) const
 {
-	return new Light(type, color, cast_shadow);
+	return new (_slot) Light(type, color, cast_shadow);
 }
 
 void Light::bind() const
@@ -65,6 +65,7 @@ void Light::onRegister()
 void Light::onDeregister()
 {
 	GraphicEngine::get()->removeLight(this);
+	GraphicEngine::get()->retire(target);
 }
 
 void Light::update(View *view)
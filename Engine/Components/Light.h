@@ -19,7 +19,7 @@ public:
 	virtual ~Light();
 
 	/// Methods (public)
-	virtual Light* clone() const override;
+	virtual Light* cloneInto(void* _slot) const override;
 
 	void bind() const;
 
@@ -27,6 +27,8 @@ public:
 	vec3 getPosition() const;
 	vec3 getDirection() const;
 	vec3 getColor() const { return color; }
+	Light::Type getLightType() const { return type; }
+	bool getCastShadow() const { return cast_shadow; }
 
 	static Light *main;
 
@@ -45,5 +47,7 @@ private:
 	RenderTargetRef target;
 	mat4 light_space;
 
+	unsigned index = ~0u; // in GraphicEngine::lights
+
 	static const Light *bound;
 };
@@ -18,9 +18,9 @@ RigidBody::~RigidBody()
 { }
 
 /// Methods (public)
-RigidBody* RigidBody::clone() const
+RigidBody* RigidBody::cloneInto(void* _slot) const
 {
-	return new RigidBody(density);
+	return new (_slot) RigidBody(density);
 }
 
 void RigidBody::computeMass()
@@ -201,6 +201,11 @@ void RigidBody::onRegister()
 	PhysicEngine::get()->addRigidBody(this);
 }
 
+void RigidBody::onReserve(unsigned _count) const
+{
+	PhysicEngine::get()->reserveRigidBodies(_count);
+}
+
 void RigidBody::onDeregister()
 {
 	for (Collider* collider: findAll<Collider>())
@@ -6,6 +6,7 @@
 class RigidBody: public Component
 {
 	friend class Entity;
+	friend class PhysicEngine;
 
 	friend class FixedConstraint;
 	friend class ContactConstraint;
@@ -16,7 +17,7 @@ class RigidBody: public Component
 		virtual ~RigidBody();
 
 		/// Methods (public)
-			virtual RigidBody* clone() const override;
+			virtual RigidBody* cloneInto(void* _slot) const override;
 
 			void computeMass();
 
@@ -47,6 +48,7 @@ class RigidBody: public Component
 		/// Methods (private)
 			virtual void onRegister() override;
 			virtual void onDeregister() override;
+			virtual void onReserve(unsigned _count) const override;
 
 		/// Attributes (private)
 			vec3 COM;
@@ -60,6 +62,8 @@ class RigidBody: public Component
 
 			float linearDamping;
 			float angularDamping;
+
+			unsigned index = ~0u; // in PhysicEngine::bodies
 };
 
 #endif // RIGIDBODY_H
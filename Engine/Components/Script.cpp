@@ -2,14 +2,16 @@
 
 #include "Systems/ScriptEngine.h"
 
-Script::Script()
+Script::Script():
+	threadSafe(false),
+	bucket(~0u), index(0)
 { }
 
 Script::~Script()
 { }
 
 /// Methods (public)
-Script* Script::clone() const
+Script* Script::cloneInto(void*) const
 {
 	return nullptr;
 }
@@ -28,6 +30,11 @@ void Script::onRegister()
 	ScriptEngine::get()->addComponent(this);
 }
 
+void Script::onReserve(unsigned _count) const
+{
+	ScriptEngine::get()->reserve(_count);
+}
+
 void Script::onDeregister()
 {
 	onDestroy();
@@ -8,13 +8,14 @@ struct Collision;
 class Script : public Component
 {
 	friend class Entity;
+	friend class ScriptEngine;
 
 	public:
 		Script();
 		virtual ~Script();
 
 		/// Methods (public)
-			virtual Script* clone() const override final;
+			virtual Script* cloneInto(void* _slot) const override final;
 
 			virtual void start	 ();
 			virtual void update	();
@@ -24,10 +25,23 @@ class Script : public Component
 			virtual void onCollision(const Collision& _collision);
 			virtual void onTrigger  (Collider* _collider);
 
+		/// Getters
+			bool isThreadSafe() const	{ return threadSafe; }
+
+	protected:
+		/// Attributes (protected)
+			// Set in the constructor to let update and lateUpdate run concurrently with other thread safe scripts.
+			// They must then only modify their own entity and use ScriptEngine::defer for structural changes.
+			bool threadSafe;
+
 	private:
 		/// Methods (private)
 			virtual void onRegister() override;
 			virtual void onDeregister() override;
+			virtual void onReserve(unsigned _count) const override;
+
+		/// Attributes (private)
+			unsigned bucket, index; // location in the ScriptEngine, bucket is ~0u while the script is not started
 };
 
 #endif // SCRIPT_H
@@ -2,6 +2,8 @@
 #include "Components/Transform.h"
 #include "Components/Camera.h"
 
+#include "Systems/GraphicEngine.h"
+
 #include "Renderer/RenderContext.inl"
 #include "Renderer/CommandKey.h"
 
@@ -109,9 +111,9 @@ Skybox::Skybox(MaterialRef material):
 }
 
 /// Methods (public)
-Skybox* Skybox::clone() const
+Skybox* Skybox::cloneInto(void* _slot) const
 {
-	return new Skybox(sky);
+	return new (_slot) Skybox(sky);
 }
 
 void Skybox::render(RenderContext *ctx, uint32_t view_id) const
@@ -123,3 +125,14 @@ void Skybox::render(RenderContext *ctx, uint32_t view_id) const
 	uint64_t key = CommandKey::encode(view_id, RenderPass::Skybox, sky->get_id(), 0.0f);
 	ctx->add(key, cmd);
 }
+
+/// Methods (private)
+void Skybox::onDeregister()
+{
+	// Commands in flight may still use them
+	if (GraphicEngine *engine = GraphicEngine::get())
+	{
+		engine->retire(mesh);
+		engine->retire(sky);
+	}
+}
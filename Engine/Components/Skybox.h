@@ -12,11 +12,15 @@ public:
 	Skybox(MaterialRef material);
 
 	/// Methods (public)
-	virtual Skybox* clone() const override;
+	virtual Skybox* cloneInto(void* _slot) const override;
 
 	void render(struct RenderContext *ctx, uint32_t view_id) const;
 
 private:
+	/// Methods (private)
+	virtual void onDeregister() override;
+
+	/// Attributes
 	MaterialRef sky;
 	MeshRef mesh;
 };
@@ -11,9 +11,9 @@ Sphere::~Sphere()
 { }
 
 /// Methods (public)
-Sphere* Sphere::clone() const
+Sphere* Sphere::cloneInto(void* _slot) const
 {
-	return new Sphere(radius, center, material, isTrigger);
+	return new (_slot) Sphere(radius, center, material, isTrigger);
 }
 
 void Sphere::computeMass()
@@ -69,13 +69,20 @@ RayHit Sphere::raycast(vec3 _o, vec3 _d)
 	return r;
 }
 
+/// Setters
+void Sphere::setRadius(float _radius)
+{
+	radius = _radius;
+	changed();
+}
+
 /// Getters
 vec3 Sphere::getSupport(vec3 _axis)
 {
 	return tr->position + (center + radius * _axis) * tr->scale;
 }
 
-float Sphere::getRadius()
+float Sphere::getRadius() const
 {
 	return radius * tr->scale.x;
 }
@@ -5,12 +5,14 @@
 
 class Sphere : public Collider
 {
+	friend class Snapshot; // saves the unscaled shape
+
 	public:
 		Sphere(float _radius = 0.5f, vec3 _center = vec3(0.0f), PhysicMaterialRef _material = NULL, bool _isTrigger = false);
 		virtual ~Sphere();
 
 		/// Methods (public)
-			virtual Sphere* clone() const override;
+			virtual Sphere* cloneInto(void* _slot) const override;
 
 			virtual void computeMass() override;
 			virtual void computeAABB() override;
@@ -20,7 +22,10 @@ class Sphere : public Collider
 		/// Getters
 			virtual vec3 getSupport(vec3 _axis) override;
 
-			float getRadius();
+			float getRadius() const;
+
+		/// Setters
+			void setRadius(float _radius);
 
 	private:
 		/// Attributes
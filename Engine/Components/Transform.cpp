@@ -14,14 +14,15 @@ Transform::~Transform()
 { }
 
 /// Methods (public)
-Transform* Transform::clone() const
+Transform* Transform::cloneInto(void* _slot) const
 {
-	return new Transform(position, rotation, scale);
+	return new (_slot) Transform(position, rotation, scale);
 }
 
 void Transform::toMatrix()
 {
 	validWorld = validLocal = false;
+	changed();
 
 	for (Transform *child : children)
 		child->updateChildren();
@@ -88,6 +89,7 @@ void Transform::setDirection(vec3 _direction)
 	rotation = glm::rotation(vec3(1, 0, 0), _direction);
 
 	validLocal = validWorld = false;
+	changed();
 }
 
 /// Getters
@@ -179,6 +181,7 @@ vec3 Transform::vectorToWorld(vec3 _vector)
 void Transform::setRoot(Transform* _root)
 {
 	validWorld = validLocal = false;
+	changed();
 
 	root = _root;
 	for (Transform* child: children)
@@ -187,10 +190,12 @@ void Transform::setRoot(Transform* _root)
 
 void Transform::updateChildren()
 {
-	if (!validWorld) // means validLocal if false too
-		return; // already dirty, no need to tell children
+	// !validWorld means validLocal is false too
+	if (!validWorld && getVersion() == ComponentType::getVersion())
+		return; // already dirty and marked as changed, no need to tell children
 
 	validWorld = validLocal = false;
+	changed();
 	for (Transform *child : children)
 		child->updateChildren();
 }
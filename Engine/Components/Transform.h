@@ -14,7 +14,7 @@ class Transform : public Component
 		virtual ~Transform();
 
 		/// Methods (public)
-			virtual Transform* clone() const override;
+			virtual Transform* cloneInto(void* _slot) const override;
 
 			void toMatrix();
 
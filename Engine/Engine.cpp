@@ -1,9 +1,17 @@
 #include "Engine.h"
 #include "Entity.h"
+#include "EntityCommandBuffer.h"
 
 #include "Systems/GraphicEngine.h"
 #include "Systems/PhysicEngine.h"
 #include "Systems/ScriptEngine.h"
+#include "Systems/Scheduler.h"
+
+#include "Components/Animator.h"
+#include "Components/Collider.h"
+#include "Components/RigidBody.h"
+#include "Components/Transform.h"
+#include "Components/Script.h"
 
 #include "Renderer/GLDriver.h"
 
@@ -11,6 +19,7 @@
 #include "Utility/Debug.h"
 #include "Utility/IO/Input.h"
 #include "Utility/JobSystem/JobSystem.h"
+#include "Utility/Memory/FrameAllocator.h"
 
 //#define MICROPROFILE_MAX_FRAME_HISTORY (2<<10)
 #define MICROPROFILE_IMPL
@@ -20,14 +29,17 @@
 #include "Components/Component.h"
 #endif
 
+#define FRAME_MEMORY (4 << 20) // per worker and per frame
+
 Engine* Engine::instance = nullptr;
 
-Engine::Engine(sf::RenderWindow* _window, unsigned _FPS):
-	clock(), pause(false)
+Engine::Engine(sf::RenderWindow* _window, unsigned _FPS, const JobSystem::Config& _jobs):
+	clock(), pause(false), pipelined(false), headless(_window == nullptr)
 {
 	instance = this;
 
-	_window->setFramerateLimit(_FPS);
+	if (!headless)
+		_window->setFramerateLimit(_FPS);
 
 #ifdef PROFILE
 	MicroProfileOnThreadCreate("Main");
@@ -40,12 +52,21 @@ Engine::Engine(sf::RenderWindow* _window, unsigned _FPS):
 #endif
 
 	Time::init();
-	JobSystem::init();
-	Input::init(_window);
+	JobSystem::init(_jobs);
+	FrameAllocator::create(FRAME_MEMORY);
+
+	if (!headless)
+	{
+		Input::init(_window);
+		GraphicEngine::create();
+	}
 
-	GraphicEngine::create();
 	PhysicEngine::create();
 	ScriptEngine::create();
+	Scheduler::create();
+	EntityCommandBuffer::create();
+
+	addSystems(!headless);
 }
 
 Engine::~Engine()
@@ -55,8 +76,11 @@ Engine::~Engine()
 	GraphicEngine::destroy();
 	PhysicEngine::destroy();
 	ScriptEngine::destroy();
+	Scheduler::destroy();
+	EntityCommandBuffer::destroy();
 
 	Input::destroy();
+	FrameAllocator::destroy();
 	JobSystem::destroy();
 
 	instance = nullptr;
@@ -81,12 +105,13 @@ void Engine::start()
 		exit(EXIT_FAILURE);
 	}
 
-	Debug::init();
+	if (!headless)
+		Debug::init();
 
 	ScriptEngine::get()->start();
 
 	GLenum err;
-	while ( ( err = glGetError() ) != GL_NO_ERROR) {
+	while (!headless && ( err = glGetError() ) != GL_NO_ERROR) {
 		std::cout << "OpenGL error detected: " << err << std::endl;
 	}
 
@@ -106,42 +131,127 @@ bool Engine::update()
 	Time::time += Time::deltaTime;
 
 	/// Update events
-	Input::update();
+	if (!headless)
+		Input::update();
+	JobSystem::reset_arena();
+	FrameAllocator::get()->flip();
 
 	if (pause)
 		return false;
 
-	/// Update scripts
-	ScriptEngine::get()->start();
-	ScriptEngine::get()->update();
+	if (headless)
+		simulate();
 
-	/// Step physic simulation
-	PhysicEngine::get()->simulate();
+	else if (pipelined)
+	{
+		/// Copy the previous step, its commands are generated and sorted while the main thread simulates
+		// main thread systems and GL calls stay on this thread
+		GraphicEngine::get()->snapshot();
 
-	/// Re-update scripts
-	ScriptEngine::get()->lateUpdate();
+		std::atomic<int> counter(0);
+		JobSystem::run(prepare, nullptr, 0, &counter);
 
-	/// Render scene
-	GraphicEngine::get()->render();
+		simulate();
+		JobSystem::wait(&counter, 1);
 
+		GraphicEngine::get()->submit();
+		GraphicEngine::get()->finish();
+	}
+	else
+	{
+		simulate();
+
+		/// Render scene
+		GraphicEngine::get()->snapshot();
+		GraphicEngine::get()->prepare();
+		GraphicEngine::get()->sort();
+		GraphicEngine::get()->submit();
+		GraphicEngine::get()->finish();
+	}
 
+	JobSystem::publish_stats();
 	MicroProfileFlip();
 
 	return true;
 }
 
+void Engine::simulate()
+{
+	MICROPROFILE_SCOPEI("ENGINE", "simulate");
+
+	Scheduler::get()->run();
+}
+
+void Engine::prepare(const void *)
+{
+	GraphicEngine::get()->prepare();
+	GraphicEngine::get()->sort();
+}
+
+void Engine::addSystems(bool _graphics)
+{
+	Scheduler *scheduler = Scheduler::get();
+
+	/// Update scripts
+	scheduler->add("scripts", []() {
+		ScriptEngine::get()->start();
+		ScriptEngine::get()->update();
+	})->writeAll()->mainThread();
+
+	/// Step physic simulation
+	// callbacks are queued, scripts get them in "collision callbacks"
+	scheduler->add("physics", []() {
+		PhysicEngine::get()->simulate();
+	})->write<Transform>()->write<RigidBody>()->write<Collider>();
+
+	/// Advance animations, concurrently with physics
+	if (_graphics)
+	{
+		scheduler->add("animation sampling", []() {
+			GraphicEngine::get()->sample();
+		})->write<Animator>();
+	}
+
+	/// Send collision callbacks
+	scheduler->add("collision callbacks", []() {
+		PhysicEngine::get()->sendEvents();
+	})->writeAll()->mainThread();
+
+	/// Re-update scripts
+	scheduler->add("late scripts", []() {
+		ScriptEngine::get()->lateUpdate();
+	})->writeAll()->mainThread();
+
+	/// Apply deferred structural changes
+	scheduler->add("entity commands", []() {
+		EntityCommandBuffer::get()->playback();
+	})->writeAll()->mainThread();
+
+	/// Pose skeletal meshes
+	if (_graphics)
+	{
+		scheduler->add("animation", []() {
+			GraphicEngine::get()->animate();
+		})->write<Transform>()->write<Animator>();
+	}
+}
+
 void Engine::clear()
 {
 	MICROPROFILE_SCOPEI("ENGINE", "clear");
 
+	EntityCommandBuffer::get()->clear();
+
 	std::cout << "Entities: "; Entity::clear();
 	std::cout << "done" << std::endl;
 
-	GraphicEngine::get()->clear();
+	if (!headless)
+		GraphicEngine::get()->clear();
 	PhysicEngine::get()->clear();
 	ScriptEngine::get()->clear();
 
-	Debug::destroy();
+	if (!headless)
+		Debug::destroy();
 
 
 #ifdef DEBUG
@@ -170,8 +280,18 @@ void Engine::setWindowSize(vec2 _newSize)
 	Input::setWindowSize(_newSize);
 }
 
+void Engine::setPipelined(bool _pipelined)
+{
+	pipelined = _pipelined;
+}
+
 /// Getters
 bool Engine::getPause() const
 {
 	return pause;
 }
+
+bool Engine::getPipelined() const
+{
+	return pipelined;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Utility/glm.h"
+#include "Utility/JobSystem/JobSystem.h"
 #include <SFML/System/Clock.hpp>
 
 namespace sf
@@ -9,7 +10,9 @@ namespace sf
 class Engine
 {
 public:
-	Engine(sf::RenderWindow* _window, unsigned _FPS = 60);
+	// Without a window the engine is headless: there is no input and nothing is rendered,
+	// so Graphic, Animator, Camera and Light components can't be used
+	Engine(sf::RenderWindow* _window, unsigned _FPS = 60, const JobSystem::Config& _jobs = JobSystem::Config());
 	~Engine();
 
 	/// Methods (static)
@@ -25,13 +28,27 @@ public:
 	void togglePause();
 	void setWindowSize(vec2 _newSize);
 
+	// In pipelined mode, views and drawables of the previous simulation step are copied, then their
+	// commands are generated and sorted on the workers while the main thread runs the next step.
+	// They are submitted once it is done, so the picture is one step behind the simulation.
+	// Graphic resources freed during the step are kept alive by GraphicEngine::retire until submission.
+	void setPipelined(bool _pipelined);
+
 	/// Getters
 	bool getPause() const;
+	bool getPipelined() const;
 
 private:
+	/// Methods (private)
+	static void simulate();
+	static void prepare(const void *);
+	static void addSystems(bool _graphics);
+
 	/// Attributes
 	sf::Clock clock;
 	bool pause;
+	bool pipelined;
+	bool headless;
 
 	/// Attributes (static)
 	static Engine* instance;
@@ -2,43 +2,66 @@
 #include <cstring>
 
 std::vector<Entity*> Entity::entities;
-SizeMap Entity::scriptSizes;
 
-Entity::Entity(Tag _tag, bool _prototype):
+std::vector<Entity::Slot> Entity::slots;
+uint32_t Entity::freeSlot = ~0u;
+
+std::vector<std::vector<Entity*>> Entity::tagged[2];
+
+Entity::Entity(Tag _tag, bool _prototype, Archetype* _archetype):
 	prototype(_prototype), tag(_tag),
-	tr(nullptr)
+	archetype(_archetype), tr(nullptr)
 {
+	row = archetype->insert(this);
+
+	if (freeSlot != ~0u)
+	{
+		slot = freeSlot;
+		freeSlot = slots[slot].next;
+	}
+	else
+	{
+		slot = slots.size();
+		slots.push_back({nullptr, 1, ~0u});
+	}
+	slots[slot].entity = this;
+
+	index = entities.size();
 	entities.push_back(this);
+
+	addToTag();
 }
 
 Entity::~Entity()
 {
-	// free components
-	for (auto& componentPair: components)
+	// free components, cleared cells are skipped by lookups made from onDeregister
+	for (unsigned i(archetype->getColumns()) ; i-- > 0 ; )
 	{
-		auto csize = componentPair.second.size();
-		for (unsigned i(0) ; i < csize ; i++)
-		{
-			if (!prototype)
-				componentPair.second.back()->onDeregister();
+		Component* c = getComponent(i);
 
-			delete componentPair.second.back();
-			componentPair.second.pop_back();
-		}
+		if (!prototype)
+			c->onDeregister();
+
+		delete c;
+		archetype->component(row, i) = nullptr;
 	}
 
+	if (Entity* moved = archetype->remove(row))
+		moved->row = row;
+
 	delete tr;
 }
 
 /// Methods (public)
 void Entity::destroy()
 {
-	auto it = std::find(entities.begin(), entities.end(), this);
-	if (it != entities.end())
-	{
-		*it = entities.back();
-		entities.pop_back();
-	}
+	Entity* last = entities.back();
+	entities[index] = last;
+	last->index = index;
+	entities.pop_back();
+
+	releaseSlot();
+	removeFromTag();
 
 	delete this;
 }
@@ -56,73 +79,119 @@ Entity* Entity::create(const Tag& _tag, bool _prototype, vec3 _position, quat _r
 
 Entity* Entity::clone(Entity* _entity, vec3 _position, vec3 _rotation, vec3 _scale)
 {
-	Entity* e = Entity::create(_entity->tag, false, _position, _rotation, _scale);
+	Placement placement{_position, quat(_rotation), _scale};
 
-	for (auto& componentPair: _entity->components)
+	return instantiate(_entity, 1, &placement).front();
+}
+
+Entity* Entity::clone(Entity* _entity)
+{
+	return instantiate(_entity, 1).front();
+}
+
+std::vector<Entity*> Entity::instantiate(Entity* _prototype, unsigned _count, const Placement* _placements)
+{
+	std::vector<Entity*> copies(_count);
+	if (_count == 0)
+		return copies;
+
+	// Same components, so same archetype
+	Archetype* archetype = _prototype->archetype;
+	unsigned columns = archetype->getColumns();
+
+	reserveMore(entities, _count);
+	archetype->reserve(_count);
+
+	Transform* source = _prototype->tr;
+	for (unsigned j(0) ; j < _count ; j++)
+	{
+		Entity* e = new Entity(_prototype->tag, false, archetype);
+
+		if (_placements)
+			e->insert<Transform>(_placements[j].position, _placements[j].rotation, _placements[j].scale);
+		else
+			e->insert<Transform>(source->position, source->rotation, source->scale);
+
+		copies[j] = e;
+	}
+
+	// Column major, components may change their entity when registered
+	std::vector<Component*> components(columns * _count);
+	for (unsigned i(0) ; i < columns ; i++)
 	{
-		auto& components = e->components[componentPair.first];
+		Component* component = _prototype->getComponent(i);
+		size_t size = ComponentType::getSize(component->type);
+
+		// The clones of a column are contiguous in the pool of their type
+		ObjectPool* pool = Component::getPool(component->type, size);
+		uint8_t* slots = static_cast<uint8_t*>(pool->alloc(_count));
 
-		for (Component* component: componentPair.second)
+		for (unsigned j(0) ; j < _count ; j++)
 		{
-			Component* c = component->clone();
+			Entity* e = copies[j];
+			void* slot = slots + j * pool->getStride();
 
+			Component* c = component->cloneInto(slot);
 			if (c == nullptr)
 			{
-				size_t s = scriptSizes[typeid(*component)];
-
-				c = reinterpret_cast<Component*>(operator new(s));
-				memcpy((void*)c, component, s);
+				c = reinterpret_cast<Component*>(slot);
+				memcpy(slot, component, size);
 #ifdef DEBUG
 				Component::instances++;
 #endif
 			}
 
-			components.push_back(c);
-
+			c->type = component->type;
 			c->entity = e;
 			c->tr = e->tr;
+
+			archetype->component(e->row, i) = c;
+			components[i * _count + j] = c;
 		}
 	}
 
-	for (auto *child : _entity->find<Transform>()->getChildren())
+	for (Transform* child : source->getChildren())
 	{
-		Entity *c = child->entity;
-		Entity::clone(c)->tr->setParent(e->tr);
-	}
+		std::vector<Entity*> children = instantiate(child->entity, _count);
 
-	for (auto& componentPair: e->components)
-	{
-		for (Component* component: componentPair.second)
-			component->onRegister();
+		for (unsigned j(0) ; j < _count ; j++)
+			children[j]->tr->setParent(copies[j]->tr);
 	}
 
-	return e;
-}
+	// Systems grow their arrays once per component type
+	for (unsigned i(0) ; i < columns ; i++)
+	{
+		components[i * _count]->onReserve(_count);
 
-Entity* Entity::clone(Entity* _entity)
-{
-	Transform* tr = _entity->find<Transform>();
+		for (unsigned j(0) ; j < _count ; j++)
+			components[i * _count + j]->onRegister();
+	}
 
-	return Entity::clone(_entity, tr->position, eulerAngles(tr->rotation), tr->scale);
+	return copies;
 }
 
 void Entity::clear()
 {
 	for(Entity* entity: entities)
+	{
+		entity->releaseSlot();
 		delete entity;
+	}
 
 	entities.clear();
+	Archetype::clear();
+
+	tagged[0].clear();
+	tagged[1].clear();
 }
 
 Entity* Entity::findByTag(const Tag& _tag, bool _allowPrototypes)
 {
-	for (Entity* entity: entities)
+	for (int prototype(0) ; prototype < 1 + _allowPrototypes ; prototype++)
 	{
-		if (entity->tag == _tag)
-		{
-			if (!entity->prototype || _allowPrototypes)
-				return entity;
-		}
+		const auto& buckets = tagged[prototype];
+		if (_tag.getId() < (int)buckets.size() && !buckets[_tag.getId()].empty())
+			return buckets[_tag.getId()].front();
 	}
 
 	return nullptr;
@@ -132,23 +201,34 @@ std::vector<Entity*> Entity::findAllByTag(const Tag& _tag, bool _allowPrototypes
 {
 	std::vector<Entity*> samedTag;
 
-	for (Entity* entity: entities)
+	for (int prototype(0) ; prototype < 1 + _allowPrototypes ; prototype++)
 	{
-		if (entity->tag == _tag)
-		{
-			if (!entity->prototype || _allowPrototypes)
-				samedTag.push_back(entity);
-		}
+		const auto& buckets = tagged[prototype];
+		if (_tag.getId() < (int)buckets.size())
+			samedTag.insert(samedTag.end(), buckets[_tag.getId()].begin(), buckets[_tag.getId()].end());
 	}
 
 	return samedTag;
 }
 
+void Entity::setTag(const Tag& _tag)
+{
+	removeFromTag();
+	tag = _tag;
+	addToTag();
+}
+
 /// Methods (private)
-void Entity::insertComponent(Component* _component, std::type_index _typeid)
+void Entity::insertComponent(Component* _component, unsigned _type, unsigned _key)
 {
-	components[_typeid].push_back(_component);
+	// New component goes after the ones of the same type
+	Archetype* to = archetype->with(_key);
+	unsigned column = to->find(_key) + to->count(_key) - 1;
 
+	move(to, column, true);
+	archetype->component(row, column) = _component;
+
+	_component->type = _type;
 	_component->entity = this;
 
 	if (!prototype)
@@ -158,17 +238,18 @@ void Entity::insertComponent(Component* _component, std::type_index _typeid)
 	}
 }
 
-void Entity::removeComponent(std::type_index _componentTypeid, std::type_index _typeid)
+void Entity::removeComponent(unsigned _type, unsigned _key)
 {
-	std::vector<Component*>& vec = components[_typeid];
+	unsigned first = archetype->find(_key);
+	unsigned count = archetype->count(_key);
 
-	for (unsigned i(0) ; i < vec.size() ; i++)
+	for (unsigned i(first) ; i < first + count ; i++)
 	{
-		Component* c = vec[i];
+		Component* c = getComponent(i);
 
-		if (std::type_index(typeid(*c)) == _componentTypeid)
+		if (c->type == _type)
 		{
-			vec.erase(vec.begin() + i);
+			move(archetype->without(_key), i, false);
 
 			if (!prototype)
 				c->onDeregister();
@@ -179,17 +260,19 @@ void Entity::removeComponent(std::type_index _componentTypeid, std::type_index _
 	}
 }
 
-void Entity::removeComponents(std::type_index _componentTypeid, std::type_index _typeid)
+void Entity::removeComponents(unsigned _type, unsigned _key)
 {
-	std::vector<Component*>& vec = components[_typeid];
+	unsigned first = archetype->find(_key);
+	unsigned count = archetype->count(_key);
 
-	for (unsigned i(0) ; i < vec.size() ; i++)
+	for (unsigned i(first) ; i < first + count ; i++)
 	{
-		Component* c = vec[i];
+		Component* c = getComponent(i);
 
-		if (std::type_index(typeid(*c)) == _componentTypeid)
+		if (c->type == _type)
 		{
-			vec.erase(vec.begin() + i--);
+			move(archetype->without(_key), i--, false);
+			count--;
 
 			if (!prototype)
 				c->onDeregister();
@@ -199,15 +282,62 @@ void Entity::removeComponents(std::type_index _componentTypeid, std::type_index
 	}
 }
 
-/// Getter (private)
-std::type_index Entity::getColliderTypeIndex()
+void Entity::addToTag()
+{
+	auto& buckets = tagged[prototype];
+	if (tag.getId() >= (int)buckets.size())
+		buckets.resize(tag.getId() + 1);
+
+	auto& bucket = buckets[tag.getId()];
+	tagIndex = bucket.size();
+	bucket.push_back(this);
+}
+
+void Entity::removeFromTag()
+{
+	auto& bucket = tagged[prototype][tag.getId()];
+
+	Entity* last = bucket.back();
+	bucket[tagIndex] = last;
+	last->tagIndex = tagIndex;
+	bucket.pop_back();
+}
+
+void Entity::releaseSlot()
 {
-	return typeid(Collider);
+	Slot& s = slots[slot];
+	s.entity = nullptr;
+	if (++s.generation == 0)
+		s.generation = 1;
+
+	s.next = freeSlot;
+	freeSlot = slot;
+}
+
+void Entity::move(Archetype* _to, unsigned _column, bool _insert)
+{
+	unsigned to_row = _to->insert(this);
+
+	for (unsigned i(0) ; i < archetype->getColumns() ; i++)
+	{
+		if (_insert)
+			_to->component(to_row, i + (i >= _column)) = getComponent(i);
+
+		else if (i != _column)
+			_to->component(to_row, i - (i > _column)) = getComponent(i);
+	}
+
+	if (Entity* moved = archetype->remove(row))
+		moved->row = row;
+
+	archetype = _to;
+	row = to_row;
 }
 
-std::type_index Entity::getScriptTypeIndex()
+/// Getter (private)
+unsigned Entity::getColliderId()
 {
-	return typeid(Script);
+	return ComponentType::id<Collider>();
 }
 
 /// Other
@@ -225,9 +355,13 @@ std::type_index Entity::getScriptTypeIndex()
 template <>
 void Entity::removeAll<Collider>()
 {
-	for (Component* collider: components[typeid(Collider)])
+	unsigned first = archetype->find(getColliderId());
+	unsigned count = archetype->count(getColliderId());
+
+	while (count--)
 	{
-		Collider* c = static_cast<Collider*>(collider);
+		Collider* c = static_cast<Collider*>(getComponent(first));
+		move(archetype->without(getColliderId()), first, false);
 
 		if (!prototype)
 			c->onDeregister();
@@ -235,8 +369,6 @@ void Entity::removeAll<Collider>()
 		delete c;
 	}
 
-	components[typeid(Collider)].clear();
-
 	RigidBody* rb = find<RigidBody>();
 	if (rb != nullptr)
 		rb->computeMass();
@@ -246,9 +378,10 @@ template <>
 std::vector<Component*> Entity::findAll()
 {
 	std::vector<Component*> _components;
+	_components.reserve(archetype->getColumns());
 
-	for (auto& componentPair: components)
-		for (Component* component: componentPair.second)
+	for (unsigned i(0) ; i < archetype->getColumns() ; i++)
+		if (Component* component = getComponent(i))
 			_components.push_back(component);
 
 	return _components;
@@ -257,12 +390,15 @@ std::vector<Component*> Entity::findAll()
 template <>
 std::vector<Collider*> Entity::findAll()
 {
-	std::vector<Component*>& _colliders = components[typeid(Collider)];
-	std::vector<Collider*> colliders; colliders.resize(_colliders.size());
+	unsigned first = archetype->find(getColliderId());
+	unsigned count = archetype->count(getColliderId());
 
-	for (unsigned i(0) ; i < _colliders.size() ; i++)
-		colliders[i] = static_cast<Collider*>(_colliders[i]);
+	std::vector<Collider*> colliders;
+	colliders.reserve(count);
+
+	for (unsigned i(0) ; i < count ; i++)
+		if (Component* collider = getComponent(first + i))
+			colliders.push_back(static_cast<Collider*>(collider));
 
 	return colliders;
 }
-
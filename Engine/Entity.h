@@ -2,51 +2,79 @@
 
 #include "Utility/Tag.h"
 #include "Utility/Error.h"
+#include "Archetype.h"
+#include "Utility/JobSystem/JobSystem.h"
+#include "Utility/Memory/ObjectPool.h"
 
-#include <typeindex>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 
+class Entity;
 class Component;
 class Transform;
 class Collider;
 class Script;
 
-typedef std::unordered_map<std::type_index, std::vector<Component*>> ComponentMap;
-typedef std::unordered_map<std::type_index, std::size_t> SizeMap;
+// Reference to an entity that can be checked after the entity is destroyed
+struct EntityHandle
+{
+	EntityHandle(): index(0), generation(0) {}
+	EntityHandle(uint32_t _index, uint32_t _generation): index(_index), generation(_generation) {}
+
+	Entity* get() const; // nullptr once the entity is destroyed
+	bool valid() const	{ return get() != nullptr; }
 
+	bool operator==(const EntityHandle& _other) const
+	{ return index == _other.index && generation == _other.generation; }
+	bool operator!=(const EntityHandle& _other) const
+	{ return !(*this == _other); }
+
+	uint32_t index, generation;
+};
 
 class Entity final
 {
+	friend class EntityCommandBuffer;
+	friend class Snapshot;
+
 public:
 	/// Method (public)
 	void destroy();
 
+	EntityHandle getHandle() const
+	{ return EntityHandle(slot, slots[slot].generation); }
+
+	const Tag& getTag() const	{ return tag; }
+	void setTag(const Tag& _tag);
+
 	template<typename T>
 	bool has()
 	{
 		if (std::is_base_of<Collider, T>::value)
-		{
-			for (Component* c: components[getColliderTypeIndex()])
-				if (typeid(*c) == typeid(T))
-					return true;
-
-			return false;
-		}
+			return find<T>() != nullptr;
 
 		else
-			return !components[typeid(T)].empty();
+		{
+			unsigned column = archetype->find(ComponentType::id<T>());
+			return column != Archetype::npos && getComponent(column) != nullptr;
+		}
 	}
 
 	template<typename T, typename... Args>
 	Entity* insert(Args&&... args)
 	{
-		if (typeid(T) == typeid(Transform))
+		static_assert(alignof(T) <= ObjectPool::ALIGNMENT, "Components are allocated with ObjectPool::ALIGNMENT");
+
+		if (std::is_same<T, Transform>::value)
 		{
 			if (tr)
 				Error::add(Error::USER, "Impossible to insert a Transform component");
 			else
 			{
-				T* c = new T(args...);
+				T* c = new (getPool<T>()) T(args...);
 				c->entity = this;
+				static_cast<ComponentOf<T>*>(c)->type = ComponentType::id<T>(); // T may hide type (Light)
 
 				tr = reinterpret_cast<Transform*>(c);
 			}
@@ -55,15 +83,10 @@ public:
 		}
 
 		else if (std::is_base_of<Collider, T>::value)
-			insertComponent(new T(args...), typeid(Collider));
+			insertComponent(new (getPool<T>()) T(args...), ComponentType::id<T>(), getColliderId());
 
 		else
-		{
-			if (std::is_base_of<Script, T>::value)
-				scriptSizes[typeid(T)] = sizeof(T);
-
-			insertComponent(new T(args...), typeid(T));
-		}
+			insertComponent(new (getPool<T>()) T(args...), ComponentType::id<T>(), ComponentType::id<T>());
 
 		return this;
 	}
@@ -72,20 +95,20 @@ public:
 	void remove()
 	{
 		if (std::is_base_of<Collider, T>::value)
-			removeComponent(typeid(T), getColliderTypeIndex());
+			removeComponent(ComponentType::id<T>(), getColliderId());
 
 		else
-			removeComponent(typeid(T), typeid(T));
+			removeComponent(ComponentType::id<T>(), ComponentType::id<T>());
 	}
 
 	template<typename T>
 	void removeAll()
 	{
 		if (std::is_base_of<Collider, T>::value)
-			removeComponents(typeid(T), getColliderTypeIndex());
+			removeComponents(ComponentType::id<T>(), getColliderId());
 
 		else
-			removeComponents(typeid(T), typeid(T));
+			removeComponents(ComponentType::id<T>(), ComponentType::id<T>());
 	}
 
 
@@ -95,86 +118,314 @@ public:
 	{
 		if (std::is_base_of<Collider, T>::value)
 		{
-			for (Component* c: components[getColliderTypeIndex()])
-				if (typeid(*c) == typeid(T))
+			unsigned first = archetype->find(getColliderId());
+			unsigned count = archetype->count(getColliderId());
+
+			for (unsigned i(0) ; i < count ; i++)
+			{
+				ComponentOf<T>* c = getComponent(first + i);
+				if (c && c->getType() == ComponentType::id<T>())
 					return static_cast<T*>(c);
+			}
 
 			return nullptr;
 		}
 
 		else
 		{
-			const auto& vec = components[typeid(T)];
-
-			return (vec.size() ? static_cast<T*>(vec.front()) : nullptr);
+			unsigned column = archetype->find(ComponentType::id<T>());
 
+			return (column != Archetype::npos ? static_cast<T*>(getComponent(column)) : nullptr);
 		}
 	}
 
 	template <typename T>
 	std::vector<T*> findAll()
 	{
-		std::vector<Component*>* vec = nullptr;
+		unsigned type = std::is_base_of<Collider, T>::value ? getColliderId() : ComponentType::id<T>();
 		std::vector<T*> allComponents;
 
-		if (std::is_base_of<Collider, T>::value)
-			vec = &components[getColliderTypeIndex()];
-
-		else
-			vec = &components[typeid(T)];
+		unsigned first = archetype->find(type);
+		unsigned count = archetype->count(type);
 
-		allComponents.reserve(vec->size());
+		allComponents.reserve(count);
 
-		for (Component* c: *vec)
-			if (typeid(*c) == typeid(T))
+		for (unsigned i(0) ; i < count ; i++)
+		{
+			ComponentOf<T>* c = getComponent(first + i);
+			if (c && c->getType() == ComponentType::id<T>())
 				allComponents.push_back( static_cast<T*>(c) );
+		}
 
 		return allComponents;
 	}
 
+	// Calls _func(Ts*...) for every entity having all the components Ts, in storage order
+	// Prototypes are skipped, _func must not add or remove components (see EntityCommandBuffer)
+	template <typename... Ts, typename F>
+	static void each(F _func)
+	{
+		static_assert(sizeof...(Ts) != 0, "each() needs at least one component type");
+
+		unsigned columns[sizeof...(Ts)];
+		for (Archetype* archetype: Archetype::all())
+		{
+			if (!match<Ts...>(archetype, columns))
+				continue;
+
+			for (unsigned chunk(0) ; chunk < archetype->getChunkCount() ; chunk++)
+				eachInChunk<Ts...>(archetype, chunk, columns, _func, std::index_sequence_for<Ts...>());
+		}
+	}
+
+	// Same as each(), with one job per chunk, _func is called concurrently
+	template <typename... Ts, typename F>
+	static void parallelEach(F _func)
+	{
+		static_assert(sizeof...(Ts) != 0, "parallelEach() needs at least one component type");
+
+		struct Chunk
+		{
+			Archetype* archetype;
+			unsigned chunk;
+			const unsigned* columns;
+			F* func;
+		};
+
+		auto job = [](const void* _data) {
+			const Chunk* c = static_cast<const Chunk*>(_data);
+			eachInChunk<Ts...>(c->archetype, c->chunk, c->columns, *c->func, std::index_sequence_for<Ts...>());
+		};
+
+		std::vector<unsigned> columns(Archetype::all().size() * sizeof...(Ts));
+		std::atomic<int> counter(0);
+		int jobs = 0;
+
+		for (unsigned i(0) ; i < Archetype::all().size() ; i++)
+		{
+			Archetype* archetype = Archetype::all()[i];
+			unsigned* cols = columns.data() + i * sizeof...(Ts);
+			if (!match<Ts...>(archetype, cols))
+				continue;
+
+			for (unsigned chunk(0) ; chunk < archetype->getChunkCount() ; chunk++, jobs++)
+			{
+				Chunk c{archetype, chunk, cols, &_func};
+				JobSystem::run(job, &c, sizeof(c), &counter);
+			}
+		}
+
+		JobSystem::wait(&counter, jobs);
+	}
+
+	// Calls _func on every component of type T that changed after _since, a value returned by ComponentType::tick()
+	// Components of prototypes are skipped, _func must not add or remove components
+	template <typename T, typename F>
+	static void eachChanged(uint32_t _since, F _func)
+	{
+		unsigned type = ComponentType::id<T>();
+		if (ComponentType::getVersion(type) <= _since)
+			return;
+
+		if (std::is_same<T, Transform>::value)
+		{
+			for (Entity* e: entities)
+			{
+				T* c = reinterpret_cast<T*>(e->tr);
+				if (!e->prototype && c->getVersion() > _since)
+					_func(c);
+			}
+			return;
+		}
+
+		unsigned key = getKey<T>();
+		for (Archetype* archetype: Archetype::all())
+		{
+			unsigned first = archetype->find(key);
+			if (first == Archetype::npos)
+				continue;
+
+			unsigned last = first + archetype->count(key);
+			for (unsigned chunk(0) ; chunk < archetype->getChunkCount() ; chunk++)
+			{
+				Entity** owners = archetype->entities(chunk);
+				unsigned size = archetype->getChunkSize(chunk);
+
+				for (unsigned column(first) ; column < last ; column++)
+				{
+					Component** components = archetype->column(chunk, column);
+					for (unsigned i(0) ; i < size ; i++)
+					{
+						ComponentOf<T>* c = components[i];
+						if (c && !owners[i]->prototype && c->getType() == type && c->getVersion() > _since)
+							_func(static_cast<T*>(c));
+					}
+				}
+			}
+		}
+	}
+
 	/// Methods (static)
 	static Entity* create(const Tag& _tag, bool _prototype = false, vec3 _position = vec3(0.0f), vec3 _rotation = vec3(0.0f), vec3 _scale = vec3(1.0f));
 	static Entity* create(const Tag& _tag, bool _prototype, vec3 _position, quat _rotation, vec3 _scale);
 
 	static Entity* clone(Entity* _entity, vec3 _position, vec3 _rotation = vec3(0.0f), vec3 _scale = vec3(1.0f));
 	static Entity* clone(Entity* _entity);
+
+	struct Placement
+	{
+		vec3 position;
+		quat rotation;
+		vec3 scale;
+	};
+
+	// Copy _prototype (and its children) _count times, components are cloned and registered type by type
+	// Copies are placed like the prototype if _placements is null
+	static std::vector<Entity*> instantiate(Entity* _prototype, unsigned _count, const Placement* _placements = nullptr);
 	static void clear();
 
+	static Entity* get(EntityHandle _handle)
+	{
+		if (_handle.index >= slots.size())
+			return nullptr;
+
+		const Slot& s = slots[_handle.index];
+		return s.generation == _handle.generation ? s.entity : nullptr;
+	}
+
 	static Entity* findByTag(const Tag& _tag, bool _allowPrototypes = false);
 	static std::vector<Entity*> findAllByTag(const Tag& _tag, bool _allowPrototypes = false);
 
 	/// Attributes (public)
 	const bool prototype;
 
-	Tag tag;
-
 private:
 	/// Methods (private)
-	Entity(Tag _tag, bool _prototype);
+	Entity(Tag _tag, bool _prototype, Archetype* _archetype = Archetype::empty());
 	~Entity();
 
-	void insertComponent(Component* _component, std::type_index _typeid);
+	// _key is the column type, Collider for every collider
+	void insertComponent(Component* _component, unsigned _type, unsigned _key);
+
+	void removeComponent(unsigned _type, unsigned _key);
+	void removeComponents(unsigned _type, unsigned _key);
 
-	void removeComponent(std::type_index _componentTypeid, std::type_index _typeid);
-	void removeComponents(std::type_index _componentTypeid, std::type_index _typeid);
+	// Move to an archetype with one column inserted at (or removed from) _column
+	void move(Archetype* _to, unsigned _column, bool _insert);
 
-	void getComponents();
+	void releaseSlot(); // invalidates handles
+
+	void addToTag();
+	void removeFromTag();
 
 	/// Getter (private)
-	std::type_index getColliderTypeIndex();
-	std::type_index getScriptTypeIndex();
+	static unsigned getColliderId();
+
+	Component* getComponent(unsigned _column)
+	{ return archetype->component(row, _column); }
+
+	/// Views (private)
+	// Component, as a type that depends on T, so that Component only has to be complete where templates are instantiated
+	template <typename T>
+	using ComponentOf = typename std::conditional<true, Component, T>::type;
+
+	template <typename T>
+	static ObjectPool* getPool()
+	{ return ComponentOf<T>::getPool(ComponentType::id<T>(), sizeof(T)); }
+
+	template <typename T>
+	static unsigned getKey()
+	{ return std::is_base_of<Collider, T>::value ? getColliderId() : ComponentType::id<T>(); }
+
+	// Fills the first column of each type, Transform is not stored in archetypes
+	template <typename... Ts>
+	static bool match(Archetype* _archetype, unsigned* _columns)
+	{
+		unsigned keys[] = { getKey<Ts>()... };
+		bool stored[] = { !std::is_same<Ts, Transform>::value... };
+
+		for (unsigned i(0) ; i < sizeof...(Ts) ; i++)
+		{
+			_columns[i] = _archetype->find(keys[i]);
+			if (stored[i] && _columns[i] == Archetype::npos)
+				return false;
+		}
+
+		return _archetype->getSize() != 0;
+	}
+
+	template <typename T>
+	static T* fetch(Archetype* _archetype, unsigned _chunk, unsigned _row, unsigned _column, Entity* _entity)
+	{
+		if (std::is_same<T, Transform>::value)
+			return reinterpret_cast<T*>(_entity->tr);
+
+		if (std::is_base_of<Collider, T>::value)
+		{
+			unsigned last = _column + _archetype->count(getColliderId());
+			for (unsigned column(_column) ; column < last ; column++)
+			{
+				ComponentOf<T>* c = _archetype->column(_chunk, column)[_row];
+				if (c && (std::is_same<T, Collider>::value || c->getType() == ComponentType::id<T>()))
+					return static_cast<T*>(c);
+			}
+			return nullptr;
+		}
+
+		return static_cast<T*>(_archetype->column(_chunk, _column)[_row]);
+	}
+
+	template <typename... Ts, typename F, size_t... I>
+	static void eachInChunk(Archetype* _archetype, unsigned _chunk, const unsigned* _columns, F& _func, std::index_sequence<I...>)
+	{
+		Entity** owners = _archetype->entities(_chunk);
+		unsigned size = _archetype->getChunkSize(_chunk);
+
+		for (unsigned row(0) ; row < size ; row++)
+		{
+			if (owners[row]->prototype)
+				continue;
+
+			void* components[] = { fetch<Ts>(_archetype, _chunk, row, _columns[I], owners[row])... };
+			if (std::find(components, components + sizeof...(Ts), nullptr) != components + sizeof...(Ts))
+				continue; // being deregistered, or no collider of that type
+
+			_func(static_cast<Ts*>(components[I])...);
+		}
+	}
 
 	/// Attributes (private)
-	ComponentMap components;
+	Tag tag;
+	uint32_t tagIndex; // in the tag bucket
+
+	Archetype* archetype;
+	unsigned row;
 
 	Transform* tr;
 
+	uint32_t slot, index; // in slots and entities
+
 	/// Attributes (static)
+	struct Slot
+	{
+		Entity* entity;
+		uint32_t generation; // starts at 1, so that a default handle is invalid
+		uint32_t next; // free list
+	};
+
 	static std::vector<Entity*> entities;
 
-	static SizeMap scriptSizes;
+	static std::vector<Slot> slots;
+	static uint32_t freeSlot;
+
+	static std::vector<std::vector<Entity*>> tagged[2]; // indexed by prototype, then tag id
 };
 
+inline Entity* EntityHandle::get() const
+{
+	return Entity::get(*this);
+}
+
 template <>
 inline Transform* Entity::find<Transform>()
 {
@@ -0,0 +1,239 @@
+#include "EntityCommandBuffer.h"
+
+#include "Components/Component.h"
+#include "Components/Transform.h"
+#include "Profiler/profiler.h"
+
+#include <algorithm>
+
+EntityCommandBuffer* EntityCommandBuffer::instance = nullptr;
+std::atomic<uint64_t> EntityCommandBuffer::generations(1);
+
+namespace
+{
+	// Recorder of this thread, valid while generation matches the buffer
+	struct RecorderCache
+	{
+		void* recorder = nullptr;
+		uint64_t generation = 0;
+	};
+
+	thread_local RecorderCache cache;
+}
+
+EntityCommandBuffer::EntityCommandBuffer():
+	generation(generations.fetch_add(1))
+{ }
+
+/// Methods (static)
+void EntityCommandBuffer::create()
+{
+	if (instance != nullptr)
+		return;
+
+	instance = new EntityCommandBuffer();
+}
+
+void EntityCommandBuffer::destroy()
+{
+	delete instance;
+	instance = nullptr;
+}
+
+EntityCommandBuffer* EntityCommandBuffer::get()
+{
+	return instance;
+}
+
+/// Methods (public)
+void EntityCommandBuffer::defer(std::function<void()> _command)
+{
+	Recorder& r = recorder();
+
+	r.calls.push_back(std::move(_command));
+	add(r, Command::CALL, 0, 0, EntityHandle(), r.calls.size() - 1);
+}
+
+void EntityCommandBuffer::instantiate(Entity* _prototype, const Entity::Placement& _placement, std::function<void(Entity*)> _init)
+{
+	Recorder& r = recorder();
+	EntityHandle prototype = _prototype->getHandle();
+
+	r.spawns.push_back({_placement, _prototype->getTag(), std::move(_init)});
+	add(r, Command::INSTANTIATE, (uint64_t)prototype.generation << 32 | prototype.index, 0, prototype, r.spawns.size() - 1);
+}
+
+void EntityCommandBuffer::create(const Tag& _tag, const Entity::Placement& _placement, std::function<void(Entity*)> _init)
+{
+	Recorder& r = recorder();
+
+	r.spawns.push_back({_placement, _tag, std::move(_init)});
+	add(r, Command::CREATE, 0, 0, EntityHandle(), r.spawns.size() - 1);
+}
+
+void EntityCommandBuffer::destroy(EntityHandle _entity)
+{
+	add(recorder(), Command::DESTROY, 0, 0, _entity, 0);
+}
+
+void EntityCommandBuffer::playback()
+{
+	MICROPROFILE_SCOPEI("ENGINE", "entity commands");
+
+	// Commands recorded during playback go to the next one
+	std::vector<std::unique_ptr<Recorder>> batch;
+	{
+		std::lock_guard<std::mutex> guard(recordersLock);
+		batch.swap(recorders);
+		generation.store(generations.fetch_add(1), std::memory_order_release);
+	}
+
+	std::vector<Command> commands;
+	for (const auto& r: batch)
+		commands.insert(commands.end(), r->commands.begin(), r->commands.end());
+
+	if (commands.empty())
+		return;
+
+	std::sort(commands.begin(), commands.end(), [](const Command& a, const Command& b) {
+		if (a.kind != b.kind) return a.kind < b.kind;
+		if (a.key != b.key) return a.key < b.key;
+		if (a.recorder != b.recorder) return a.recorder < b.recorder;
+		return a.order < b.order;
+	});
+
+	std::vector<Entity::Placement> placements;
+	std::vector<Component*> components;
+	std::vector<size_t> valid;
+
+	size_t i(0);
+	while (i < commands.size())
+	{
+		// Commands of the same kind and key form a group
+		size_t end = i + 1;
+		while (end < commands.size() && commands[end].kind == commands[i].kind && commands[end].key == commands[i].key)
+			end++;
+
+		switch (commands[i].kind)
+		{
+		case Command::CALL:
+			for (size_t j(i) ; j < end ; j++)
+				batch[commands[j].recorder]->calls[commands[j].payload]();
+			break;
+
+		case Command::INSTANTIATE:
+		{
+			Entity* prototype = commands[i].entity.get();
+			if (prototype == nullptr)
+				break;
+
+			placements.clear();
+			for (size_t j(i) ; j < end ; j++)
+				placements.push_back(batch[commands[j].recorder]->spawns[commands[j].payload].placement);
+
+			std::vector<Entity*> copies = Entity::instantiate(prototype, placements.size(), placements.data());
+
+			for (size_t j(i) ; j < end ; j++)
+			{
+				const Spawn& spawn = batch[commands[j].recorder]->spawns[commands[j].payload];
+				if (spawn.init) spawn.init(copies[j - i]);
+			}
+			break;
+		}
+
+		case Command::CREATE:
+			for (size_t j(i) ; j < end ; j++)
+			{
+				const Spawn& spawn = batch[commands[j].recorder]->spawns[commands[j].payload];
+				const Entity::Placement& p = spawn.placement;
+
+				Entity* e = Entity::create(spawn.tag, false, p.position, p.rotation, p.scale);
+				if (spawn.init) spawn.init(e);
+			}
+			break;
+
+		case Command::INSERT:
+		{
+			valid.clear();
+			components.clear();
+			for (size_t j(i) ; j < end ; j++)
+			{
+				if (commands[j].entity.valid())
+				{
+					valid.push_back(j);
+					components.push_back(batch[commands[j].recorder]->factories[commands[j].payload]());
+				}
+			}
+
+			if (components.empty())
+				break;
+
+			// Grouped by column: colliders of different types still reserve in the same engine
+			components.front()->onReserve(components.size());
+
+			// onRegister may destroy a later target
+			for (size_t j(0) ; j < valid.size() ; j++)
+			{
+				const Command& c = commands[valid[j]];
+				if (Entity* e = c.entity.get())
+					e->insertComponent(components[j], c.type, c.key);
+				else
+					delete components[j];
+			}
+			break;
+		}
+
+		case Command::REMOVE:
+			for (size_t j(i) ; j < end ; j++)
+			{
+				if (Entity* e = commands[j].entity.get())
+					e->removeComponent(commands[j].type, commands[j].key);
+			}
+			break;
+
+		case Command::DESTROY:
+			for (size_t j(i) ; j < end ; j++)
+			{
+				if (Entity* e = commands[j].entity.get())
+					e->destroy();
+			}
+			break;
+		}
+
+		i = end;
+	}
+}
+
+void EntityCommandBuffer::clear()
+{
+	std::lock_guard<std::mutex> guard(recordersLock);
+
+	recorders.clear();
+	generation.store(generations.fetch_add(1), std::memory_order_release);
+}
+
+/// Methods (private)
+EntityCommandBuffer::Recorder& EntityCommandBuffer::recorder()
+{
+	RecorderCache& c = cache;
+	uint64_t current = generation.load(std::memory_order_acquire);
+	if (c.generation == current)
+		return *static_cast<Recorder*>(c.recorder);
+
+	std::lock_guard<std::mutex> guard(recordersLock);
+
+	Recorder* r = new Recorder();
+	r->index = (uint32_t)recorders.size();
+	recorders.emplace_back(r);
+
+	c.recorder = r;
+	c.generation = generation.load(std::memory_order_relaxed);
+	return *r;
+}
+
+void EntityCommandBuffer::add(Recorder& _recorder, Command::Kind _kind, uint64_t _key, unsigned _type, EntityHandle _entity, size_t _payload)
+{
+	uint32_t order = _recorder.commands.size();
+
+	_recorder.commands.push_back({_kind, _key, _type, _entity, (uint32_t)_payload, _recorder.index, order});
+}
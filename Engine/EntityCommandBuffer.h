@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Entity.h"
+
+#include <functional>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+// Records structural changes from any thread and applies them at a sync point
+// Commands are sorted before playback: deferred calls, instantiations grouped by prototype, creations,
+// insertions grouped by component type, removals and finally destructions. Commands targeting an
+// entity (or instantiating a prototype) that no longer exists are skipped.
+class EntityCommandBuffer
+{
+	friend class Engine;
+
+public:
+	EntityCommandBuffer();
+
+	/// Methods (static)
+	static EntityCommandBuffer* get(); // played back after each parallel script batch and after the late update
+
+	/// Methods (public)
+	void defer(std::function<void()> _command); // runs at playback, before the other commands
+	void instantiate(Entity* _prototype, const Entity::Placement& _placement, std::function<void(Entity*)> _init = nullptr);
+	void create(const Tag& _tag, const Entity::Placement& _placement, std::function<void(Entity*)> _init = nullptr);
+	void destroy(EntityHandle _entity);
+
+	template <typename T, typename... Args>
+	void insert(EntityHandle _entity, Args... _args)
+	{
+		static_assert(!std::is_same<T, Transform>::value, "Impossible to insert a Transform component");
+		static_assert(alignof(T) <= ObjectPool::ALIGNMENT, "Components are allocated with ObjectPool::ALIGNMENT");
+
+		Recorder& r = recorder();
+		unsigned type = ComponentType::id<T>();
+		unsigned key = std::is_base_of<Collider, T>::value ? Entity::getColliderId() : type;
+
+		r.factories.emplace_back([=]() -> Component* { return new (Entity::getPool<T>()) T(_args...); });
+		add(r, Command::INSERT, key, type, _entity, r.factories.size() - 1);
+	}
+
+	template <typename T>
+	void remove(EntityHandle _entity)
+	{
+		unsigned type = ComponentType::id<T>();
+		unsigned key = std::is_base_of<Collider, T>::value ? Entity::getColliderId() : type;
+
+		add(recorder(), Command::REMOVE, key, type, _entity, 0);
+	}
+
+	void playback(); // main thread, commands recorded meanwhile go to the next playback
+	void clear();
+
+private:
+	struct Command
+	{
+		enum Kind : uint8_t { CALL, INSTANTIATE, CREATE, INSERT, REMOVE, DESTROY };
+
+		Kind kind;
+		uint64_t key;		// prototype handle or column type
+		unsigned type;		// component type
+		EntityHandle entity;	// target, or prototype
+		uint32_t payload;	// index in the recorder arrays
+		uint32_t recorder, order; // recording order, to keep sorting stable
+	};
+
+	struct Spawn
+	{
+		Entity::Placement placement;
+		Tag tag; // ignored for instantiations
+		std::function<void(Entity*)> init;
+	};
+
+	// One per recording thread and per playback
+	struct Recorder
+	{
+		uint32_t index; // in recorders
+		std::vector<Command> commands;
+
+		std::vector<Spawn> spawns;
+		std::vector<std::function<Component*()>> factories;
+		std::vector<std::function<void()>> calls;
+	};
+
+	/// Methods (private)
+	Recorder& recorder();
+	void add(Recorder& _recorder, Command::Kind _kind, uint64_t _key, unsigned _type, EntityHandle _entity, size_t _payload);
+
+	static void create();
+	static void destroy();
+
+	/// Attributes (private)
+	std::vector<std::unique_ptr<Recorder>> recorders;
+	std::mutex recordersLock;
+	std::atomic<uint64_t> generation; // thread caches from another generation get a new recorder
+
+	/// Attributes (static)
+	static EntityCommandBuffer* instance;
+	static std::atomic<uint64_t> generations;
+};
@@ -16,6 +16,8 @@
 
 #include "Engine.h"
 #include "Entity.h"
+#include "EntityCommandBuffer.h"
+#include "Snapshot.h"
 
 #include "Systems/GraphicEngine.h"
 #include "Systems/PhysicEngine.h"
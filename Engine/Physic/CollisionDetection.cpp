@@ -9,7 +9,7 @@
 
 #include "Utility/Debug.h"
 
-#include <set>
+#include <algorithm>
 
 
 struct Point
@@ -217,55 +217,60 @@ typedef std::pair<unsigned, unsigned> Edge;
 static void addEdge(std::vector<Edge>& edges, Edge b);
 static void getBarycentricCoordinates(const vec3& point, const Face& triangle, vec3& lambdas);
 
-static Manifold* EPA(Collider* _a, Collider* _b, Simplex& _simplex)
+static bool EPA(Collider* _a, Collider* _b, Simplex& _simplex, Manifold& _manifold)
 {
 	static unsigned maxSteps = 20;
 
+	// Reused between calls, see detect_default
+	static std::vector<Face> faces;
+	static std::vector<Edge> edges;
+
 	Face::simplex = &_simplex;
 
-	std::multiset<Face, Closer> faces;
-	std::multiset<Face, Closer>::iterator closest;
-		faces.insert(Face(3, 2, 1)); // ABC
-		faces.insert(Face(3, 1, 0)); // ACD
-		faces.insert(Face(3, 0, 2)); // ADB
-		faces.insert(Face(2, 0, 1)); // BDC
+	faces.clear();
+		faces.push_back(Face(3, 2, 1)); // ABC
+		faces.push_back(Face(3, 1, 0)); // ACD
+		faces.push_back(Face(3, 0, 2)); // ADB
+		faces.push_back(Face(2, 0, 1)); // BDC
 
 
 	unsigned steps = 0;
 	float distance;
+	Face closest = faces.front();
 
 	while (steps++ < maxSteps)
 	{
-		closest = faces.begin();
+		closest = *std::min_element(faces.begin(), faces.end(), Closer());
 
 		/// Recherche du point de support
-		Point supportPoint = support(_a, _b, closest->normal);
-		distance = dot(supportPoint.p, closest->normal);
+		Point supportPoint = support(_a, _b, closest.normal);
+		distance = dot(supportPoint.p, closest.normal);
 
 		/// Test de la condition de terminaison
-		if (epsilonEqual(distance, closest->distance, EPSILON))  // On ne peut plus agrandir le polytope: on a la solution
+		if (epsilonEqual(distance, closest.distance, EPSILON))  // On ne peut plus agrandir le polytope: on a la solution
 			break;
 
 		/// Agrandissement du polytope
-		std::vector<Edge> edges;
+		edges.clear();
 
-		auto faceIt = faces.begin();
-		while(faceIt != faces.end())
+		size_t i = 0;
+		while (i < faces.size())
 		{
 			// Si le produit scalaire est positif, le polytope sera concave
-			if (dot(faceIt->normal, supportPoint.p - _simplex[faceIt->a].p) >= 0.0f)
+			if (dot(faces[i].normal, supportPoint.p - _simplex[faces[i].a].p) >= 0.0f)
 			{
 				// On garde donc les bords
 				// Si il y en a un en double, on le retire de la liste
-				addEdge(edges, Edge(faceIt->a, faceIt->b));
-				addEdge(edges, Edge(faceIt->b, faceIt->c));
-				addEdge(edges, Edge(faceIt->c, faceIt->a));
+				addEdge(edges, Edge(faces[i].a, faces[i].b));
+				addEdge(edges, Edge(faces[i].b, faces[i].c));
+				addEdge(edges, Edge(faces[i].c, faces[i].a));
 
 				// On supprime cette face de la liste
-				faceIt = faces.erase(faceIt);
+				faces[i] = faces.back();
+				faces.pop_back();
 			}
 			else
-				++faceIt;
+				i++;
 		}
 
 
@@ -274,25 +279,24 @@ static Manifold* EPA(Collider* _a, Collider* _b, Simplex& _simplex)
 		unsigned spIndex = _simplex.size() -1;
 
 		for (auto& edge: edges)
-			faces.insert(Face(spIndex, edge.first, edge.second));
+			faces.push_back(Face(spIndex, edge.first, edge.second));
 	}
 
 	/// Genere les informations de contact
 	vec3 lambdas; // Coordonnes barycentriques du projet de l'origine sur la face la plus proche
-	getBarycentricCoordinates(distance * closest->normal, *closest, lambdas);
+	getBarycentricCoordinates(distance * closest.normal, closest, lambdas);
 
-	vec3 A1 = _simplex[closest->a].supA, A2 = _simplex[closest->b].supA, A3 = _simplex[closest->c].supA;
-	vec3 B1 = _simplex[closest->a].supB, B2 = _simplex[closest->b].supB, B3 = _simplex[closest->c].supB;
+	vec3 A1 = _simplex[closest.a].supA, A2 = _simplex[closest.b].supA, A3 = _simplex[closest.c].supA;
+	vec3 B1 = _simplex[closest.a].supB, B2 = _simplex[closest.b].supB, B3 = _simplex[closest.c].supB;
 
-	Manifold* man = new Manifold;
-		man->points[0] = lambdas.x*A1 + lambdas.y*A2 + lambdas.z*A3;
-		man->points[1] = lambdas.x*B1 + lambdas.y*B2 + lambdas.z*B3;
+	_manifold.points[0] = lambdas.x*A1 + lambdas.y*A2 + lambdas.z*A3;
+	_manifold.points[1] = lambdas.x*B1 + lambdas.y*B2 + lambdas.z*B3;
 
-		man->normal = closest->normal;
-		man->penetration = -distance;
-		computeBasis(man->normal, man->u, man->v);
+	_manifold.normal = closest.normal;
+	_manifold.penetration = -distance;
+	computeBasis(_manifold.normal, _manifold.u, _manifold.v);
 
-	return man;
+	return true;
 }
 
 Simplex* Face::simplex;
@@ -367,11 +371,11 @@ static void computeBasis(const vec3& a, vec3& b, vec3& c)
 }
 
 /// Collision detection functions
-Manifold* detect_SphereSphere(Collider* _a, Collider* _b)
+bool detect_SphereSphere(Collider* _a, Collider* _b, Manifold& _manifold)
 {
 	Sphere* a = reinterpret_cast<Sphere*>(_a);
 	Sphere* b = reinterpret_cast<Sphere*>(_b);
-	Manifold* man;
+	Manifold* man = &_manifold;
 
 	vec3 normal = b->find<Transform>()->position - a->find<Transform>()->position;
 
@@ -380,7 +384,6 @@ Manifold* detect_SphereSphere(Collider* _a, Collider* _b)
 	float squaredDistance = length2(normal);
 	if (epsilonEqual(squaredDistance, 0.0f, EPSILON*EPSILON))
 	{
-		man = new Manifold;
 		man->normal = vec3(0, 0, 1);
 		man->penetration = -radiusSum;
 	}
@@ -388,25 +391,27 @@ Manifold* detect_SphereSphere(Collider* _a, Collider* _b)
 	{
 		float distance = sqrt(squaredDistance);
 
-		man = new Manifold;
 		man->normal = normal / distance;
 		man->penetration = -radiusSum + distance;
 	}
 	else
-		return nullptr;
+		return false;
 
 	man->points[0] = a->find<Transform>()->position + a->getRadius() * man->normal;
 	man->points[1] = b->find<Transform>()->position - b->getRadius() * man->normal;
 	computeBasis(man->normal, man->u, man->v);
 
-	return man;
+	return true;
 }
 
-Manifold* detect_default(Collider* _a, Collider* _b)
+bool detect_default(Collider* _a, Collider* _b, Manifold& _manifold)
 {
-	Simplex simplex;
+	// Reused between calls to stay off the heap, collisions are detected on one thread
+	static Simplex simplex;
+	simplex.clear();
+
 	if (!GJK(_a, _b, simplex))
-		return nullptr;
+		return false;
 
-	return EPA(_a, _b, simplex);
+	return EPA(_a, _b, simplex, _manifold);
 }
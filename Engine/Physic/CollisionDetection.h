@@ -3,5 +3,6 @@
 class Collider;
 struct Manifold;
 
-Manifold* detect_default(Collider* _a, Collider* _b);
-Manifold* detect_SphereSphere(Collider* _a, Collider* _b);
+// Fill _manifold and return true if the colliders intersect
+bool detect_default(Collider* _a, Collider* _b, Manifold& _manifold);
+bool detect_SphereSphere(Collider* _a, Collider* _b, Manifold& _manifold);
@@ -7,6 +7,8 @@
 
 class Constraint
 {
+	friend class PhysicEngine;
+
 	public:
 		Constraint();
 		virtual ~Constraint();
@@ -16,6 +18,9 @@ class Constraint
 
 	protected:
 		float accumulatedLambda;
+
+	private:
+		unsigned index = ~0u; // in PhysicEngine::constraints
 };
 
 #endif // CONSTRAINT_H
@@ -13,7 +13,7 @@ ContactConstraint::ContactConstraint(Collider* _a, Collider* _b):
 	entities{_a->getEntity(), _b->getEntity()},
 	bodies{ _a->rigidBody, _b->rigidBody},
 	colliders{ _a, _b },
-	manifold(nullptr), type(0),
+	type(0),
 	velAlongNormal(0.0f),
 	accumulatedFrictionU(0.0f), accumulatedFrictionV(0.0f)
 { }
@@ -23,9 +23,7 @@ ContactConstraint::~ContactConstraint()
 
 bool ContactConstraint::positionConstraint()
 {
-	manifold = Dispatcher::getManifold(colliders[0], colliders[1]);
-
-	if (manifold == nullptr || manifold->penetration >= 0.0f)
+	if (!Dispatcher::getManifold(colliders[0], colliders[1], manifold) || manifold.penetration >= 0.0f)
 		return false;
 
 
@@ -44,8 +42,8 @@ bool ContactConstraint::positionConstraint()
 
 
 	// Vector from COM to contact points
-		qA = manifold->points[0] - bodies[0]->getCOM();
-		qB = manifold->points[1] - bodies[1]->getCOM();
+		qA = manifold.points[0] - bodies[0]->getCOM();
+		qB = manifold.points[1] - bodies[1]->getCOM();
 
 	for (unsigned i(0) ; i < 3 ; i++)
 	{
@@ -75,7 +73,7 @@ bool ContactConstraint::positionConstraint()
 
 	vec3 relativeVelocity = bodies[1]->linearVelocity + bCb -
 							bodies[0]->linearVelocity - aCa;
-	velAlongNormal = dot( relativeVelocity, manifold->normal );
+	velAlongNormal = dot( relativeVelocity, manifold.normal );
 
 	return true;
 }
@@ -84,7 +82,7 @@ void ContactConstraint::velocityConstraint(float _dt)
 {
 	/// Contact impulse
 	// Compute J
-		vec3 J[4] = { -manifold->normal, -cross(qA, manifold->normal), manifold->normal, cross(qB, manifold->normal) };
+		vec3 J[4] = { -manifold.normal, -cross(qA, manifold.normal), manifold.normal, cross(qB, manifold.normal) };
 
 	//					  1
 	// Compute Meff =   ----------
@@ -100,7 +98,7 @@ void ContactConstraint::velocityConstraint(float _dt)
 	// Compute lambda = -Meff * (Jv + b)
 		float Jv = dot(J[0], bodies[0]->linearVelocity) + dot(J[1], bodies[0]->angularVelocity) +
 				   dot(J[2], bodies[1]->linearVelocity) + dot(J[3], bodies[1]->angularVelocity);
-		float b = re * velAlongNormal + (BETA / _dt) * min(manifold->penetration + EPSILON, 0.0f);
+		float b = re * velAlongNormal + (BETA / _dt) * min(manifold.penetration + EPSILON, 0.0f);
 
 		float lambda = -Meff * (Jv + b);
 
@@ -117,7 +115,7 @@ void ContactConstraint::velocityConstraint(float _dt)
 
 	/// Friction impulse
 		// U axis
-		vec3 J1[4] = { -manifold->u, -cross(qA, manifold->u), manifold->u, cross(qB, manifold->u) };
+		vec3 J1[4] = { -manifold.u, -cross(qA, manifold.u), manifold.u, cross(qB, manifold.u) };
 
 		angular0 = dot(bodies[0]->iI * J1[1], J1[1]);
 		angular1 = dot(bodies[1]->iI * J1[3], J1[3]);
@@ -129,7 +127,7 @@ void ContactConstraint::velocityConstraint(float _dt)
 		float lambdaU = -Meff * J1v;
 
 		// V axis
-		vec3 J2[4] = { -manifold->v, -cross(qA, manifold->v), manifold->v, cross(qB, manifold->v) };
+		vec3 J2[4] = { -manifold.v, -cross(qA, manifold.v), manifold.v, cross(qB, manifold.v) };
 
 		angular0 = dot(bodies[0]->iI * J2[1], J2[1]);
 		angular1 = dot(bodies[1]->iI * J2[3], J2[3]);
@@ -156,18 +154,18 @@ void ContactConstraint::velocityConstraint(float _dt)
 	bodies[1]->applyImpulse(J2[2], J2[3], lambdaV);
 }
 
-void ContactConstraint::sendData()
+void ContactConstraint::sendData(std::vector<ContactEvent>& _events)
 {
 	if (type == 0)
 	{
-		qA = manifold->points[0] - bodies[0]->getCOM();
-		qB = manifold->points[1] - bodies[1]->getCOM();
+		qA = manifold.points[0] - bodies[0]->getCOM();
+		qB = manifold.points[1] - bodies[1]->getCOM();
 
 
 		Collision col;
 
-		col.normal = manifold->normal;
-		col.impulse = accumulatedLambda * manifold->normal;
+		col.normal = manifold.normal;
+		col.impulse = accumulatedLambda * manifold.normal;
 		col.relativeVelocity = bodies[1]->linearVelocity + cross( bodies[1]->angularVelocity, qB ) -
 							   bodies[0]->linearVelocity - cross( bodies[0]->angularVelocity, qA );
 
@@ -177,17 +175,21 @@ void ContactConstraint::sendData()
 			col.entity = entities[1-i];
 			col.collider = colliders[1-i];
 
-			col.point = manifold->points[1-i];
+			col.point = manifold.points[1-i];
 
-			for (auto script: colliders[i]->getEntity()->findAll<Script>())
-				script->onCollision(col);
+			_events.push_back({entities[i], col, false});
 		}
 	}
 	else
 	{
 		for (unsigned i(0) ; i < 2 ; i++)
-			for (auto script: colliders[i]->getEntity()->findAll<Script>())
-				script->onTrigger(colliders[1-i]);
+		{
+			Collision col = {};
+			col.entity = entities[1-i];
+			col.collider = colliders[1-i];
+
+			_events.push_back({entities[i], col, true});
+		}
 	}
 }
 
@@ -204,7 +206,7 @@ void Dispatcher::clear()
 	functions.clear();
 }
 
-Manifold* Dispatcher::getManifold(Collider* _a, Collider* _b)
+bool Dispatcher::getManifold(Collider* _a, Collider* _b, Manifold& _manifold)
 {
 	std::type_index a = typeid(*_a);
 	std::type_index b = typeid(*_b);
@@ -214,7 +216,7 @@ Manifold* Dispatcher::getManifold(Collider* _a, Collider* _b)
 
 	auto it = functions.find( key(a, b) );
 	if (it != functions.end())
-		return (it->second)(_a, _b);
+		return (it->second)(_a, _b, _manifold);
 
-	return detect_default(_a, _b);
+	return detect_default(_a, _b, _manifold);
 }
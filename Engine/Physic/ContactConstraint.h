@@ -3,6 +3,7 @@
 
 #include <functional>
 #include <typeindex>
+#include <vector>
 #include <map>
 
 #include "Physic/Constraint.h"
@@ -13,7 +14,17 @@ class Entity;
 class Collider;
 class RigidBody;
 
-struct Manifold;
+struct ContactEvent;
+
+struct Manifold
+{
+	vec3 points[2];
+
+	float penetration;  // penetration of deepest point
+	vec3 normal;		// Normal to the plane of collision
+	vec3 u, v;		  // (normal, u, v) is a basis of R^3. Used for friction
+	vec3 t;
+};
 
 class ContactConstraint : public Constraint
 {
@@ -24,14 +35,14 @@ class ContactConstraint : public Constraint
 		bool positionConstraint();		  // Generate contact information
 		void velocityConstraint(float _dt); // Solve impulse and apply
 
-		void sendData();					// Callback for scripts
+		void sendData(std::vector<ContactEvent>& _events); // Callbacks for scripts
 
 	/// Attributes (public)
 		Entity* entities[2];
 		RigidBody* bodies[2];
 		Collider*  colliders[2];
 
-		Manifold* manifold;
+		Manifold manifold;
 
 		unsigned type;  // 0: Collision
 						// 1: Trigger
@@ -46,16 +57,6 @@ class ContactConstraint : public Constraint
 
 };
 
-struct Manifold
-{
-	vec3 points[2];
-
-	float penetration;  // penetration of deepest point
-	vec3 normal;		// Normal to the plane of collision
-	vec3 u, v;		  // (normal, u, v) is a basis of R^3. Used for friction
-	vec3 t;
-};
-
 struct Collision
 {
 	Entity* entity;
@@ -69,16 +70,24 @@ struct Collision
 	vec3 relativeVelocity;
 };
 
+// Callback waiting to be sent to the scripts of an entity
+struct ContactEvent
+{
+	Entity* receiver;
+	Collision collision; // only collider is set for triggers
+	bool trigger;
+};
+
 class Dispatcher
 {
 	public:
 		typedef std::pair<std::type_index, std::type_index> key;
-		typedef std::function<Manifold*(Collider*, Collider*)> collisionFunction;
+		typedef std::function<bool(Collider*, Collider*, Manifold&)> collisionFunction;
 
 		static void fill();
 		static void clear();
 
-		static Manifold* getManifold(Collider* _a, Collider* _b);
+		static bool getManifold(Collider* _a, Collider* _b, Manifold& _manifold);
 
 		template <typename A, typename B>
 		static void addEntry(collisionFunction func)
@@ -1,6 +1,33 @@
 #include "Renderer/RenderContext.h"
 #include "Renderer/Commands.h"
 
+#include "Utility/JobSystem/JobSystem.inl"
+#include "Utility/Memory/FrameAllocator.h"
+#include "Profiler/profiler.h"
+
+#include <cstring>
+
+struct merge_cmd_data
+{
+	RenderContext::CommandPair *pairs;
+	RenderContext *ctx;
+};
+
+void merge_cmd(const void *_data)
+{
+	auto *data = static_cast<const merge_cmd_data*>(_data);
+	auto *pairs = data->pairs;
+
+	const auto &pool = data->ctx->commands;
+	for (size_t b(0); b < pool.block; b++)
+	{
+		memcpy(pairs, pool.blocks[b], pool.block_bytes);
+		pairs += pool.block_bytes / sizeof(*pairs);
+	}
+	memcpy(pairs, pool.blocks[pool.block], pool.index);
+	data->ctx->clear();
+}
+
 void RenderContext::add(uint64_t key, void *cmd)
 {
 	void *packet = CommandPacket::fromCommand(cmd);
@@ -15,3 +42,38 @@ void RenderContext::clear()
 	commands.clear();
 	packets.clear();
 }
+
+RenderContext::CommandPair *RenderContext::sort(RenderContext *contexts, unsigned count, size_t &pair_count)
+{
+	// Merge
+	size_t cmd_count = 0;
+	CommandPair *pairs;
+
+	{ MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "merge contexts");
+	for (unsigned i(0); i < count; i++)
+		cmd_count += contexts[i].cmd_count();
+	pairs = FrameAllocator::get()->alloc<CommandPair>(cmd_count);
+
+	cmd_count = 0;
+	std::atomic<int> counter(0);
+	for (unsigned i(0); i < count; i++)
+	{
+		// the job clears the context, read its size first
+		size_t size = contexts[i].cmd_count();
+
+		merge_cmd_data data = {pairs + cmd_count, contexts + i};
+		JobSystem::run(merge_cmd, &data, &counter);
+		cmd_count += size;
+	}
+	JobSystem::wait(&counter, count);
+	}
+
+	// Sort
+	{ MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "sort commands");
+	auto *buffer = FrameAllocator::get()->alloc<CommandPair>(cmd_count);
+	JobSystem::parallel_sort(pairs, (unsigned)cmd_count, buffer);
+	}
+
+	pair_count = cmd_count;
+	return pairs;
+}
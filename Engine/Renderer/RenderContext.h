@@ -18,10 +18,13 @@ struct RenderContext
 		uint64_t key;
 		void *packet;
 
-		inline bool operator<(const CommandPair &other)
+		inline bool operator<(const CommandPair &other) const
 		{ return key < other.key; }
 	};
 
+	// Merges the commands of the contexts in frame memory, sorted by key, then clears the contexts
+	static CommandPair *sort(RenderContext *contexts, unsigned count, size_t &pair_count);
+
 	BlockAllocator<2048, CommandPair> commands;
-	StackAllocator<4096> packets;
+	StackAllocator<4096> packets{120}; // cleared every frame, trimmed every 120 frames
 };
@@ -6,6 +6,7 @@
 
 #include "Utility/Debug.h"
 #include "Utility/JobSystem/JobSystem.inl"
+#include "Utility/Memory/FrameAllocator.h"
 #include "Profiler/profiler.h"
 
 #include "Assets/Shader.h"
@@ -28,54 +29,54 @@ struct create_cmd_data
 
 void create_cmd(const void *_data)
 {
-	auto *data = static_cast<const JobSystem::ParallelFor<Graphic*, create_cmd_data>*>(_data);
+	auto *data = static_cast<const JobSystem::ParallelFor<Drawable, create_cmd_data>*>(_data);
 
 	auto *ctx = data->user_data.contexts + JobSystem::worker_id();
 	auto *views = data->user_data.views;
 	auto view_count = data->user_data.view_count;
 
-	auto **it = (const Graphic**)data->start;
-	auto **last = (const Graphic**)data->end;
+	auto *it = data->start;
+	auto *last = data->end;
 	while (it != last)
-		(*it++)->render(ctx, view_count, views);
+		(it++)->render(ctx, view_count, views);
 }
 
-struct merge_cmd_data
+void GraphicEngine::render()
 {
-	RenderContext::CommandPair *pairs;
-	RenderContext *ctx;
-};
+	MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "render");
 
-void merge_cmd(const void *_data)
+	sample();
+	animate();
+	snapshot();
+	prepare();
+	sort();
+	submit();
+	finish();
+}
+
+void GraphicEngine::sample()
 {
-	auto *data = static_cast<const merge_cmd_data*>(_data);
-	auto *pairs = data->pairs;
+	MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "sample");
 
-	const auto &pool = data->ctx->commands;
-	for (size_t b(0); b < pool.block; b++)
-	{
-		memcpy(pairs, pool.blocks[b], pool.block_bytes);
-		pairs += pool.block_bytes;
-	}
-	memcpy(pairs, pool.blocks[pool.block], pool.index);
-	data->ctx->clear();
+	for (Animator* animator: animators)
+		animator->sample();
 }
 
-void GraphicEngine::render()
+void GraphicEngine::animate()
 {
-	MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "render");
+	MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "animate");
 
 	// Animate skeletal meshes
-	{ MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "animate");
 	for (Animator* animator: animators)
 		animator->animate();
-	}
-
+}
 
-	//glEnable(GL_SCISSOR_TEST);
+void GraphicEngine::snapshot()
+{
+	MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "snapshot");
 
-	// Lights and cameras
-	uint32_t view_count = 0;
+	// Lights and cameras, their commands wait in the main thread context until the next sort
+	view_count = 0;
 	{ MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "views");
 
 	for (size_t i(0); i < lights.size(); i++)
@@ -109,13 +110,23 @@ void GraphicEngine::render()
 	}
 	}
 
-	unsigned worker_count = JobSystem::worker_count();
+	// Graphics, world matrices are computed lazily so this stays on one thread
+	{ MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "drawables");
+
+	drawable_count = graphics.size();
+	drawables = FrameAllocator::get()->alloc<Drawable>(drawable_count);
+
+	for (size_t i(0); i < drawable_count; i++)
+		graphics[i]->snapshot(drawables + i);
+	}
+}
 
-	// Create commands
-	{ MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "create commands");
+void GraphicEngine::prepare()
+{
+	MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "prepare");
 
-	JobSystem::ParallelFor<Graphic*, create_cmd_data> data{
-		graphics.data(), (unsigned)graphics.size(),
+	JobSystem::ParallelFor<Drawable, create_cmd_data> data{
+		drawables, (unsigned)drawable_count,
 		contexts, views, view_count
 	};
 
@@ -125,44 +136,77 @@ void GraphicEngine::render()
 	);
 
 	JobSystem::wait(&counter, jobs);
-	}
-
-	// Merge
-	RenderContext::CommandPair *pairs;
-	size_t cmd_count = 0;
 
-	{ MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "merge contexts");
-	for (unsigned i(0); i < worker_count; i++)
-		cmd_count += contexts[i].cmd_count();
-	pairs = new RenderContext::CommandPair[cmd_count];
+	drawables = nullptr;
+	drawable_count = 0;
+}
 
-	cmd_count = 0;
-	std::atomic<int> counter(0);
-	for (unsigned i(0); i < worker_count; i++)
+void Drawable::render(RenderContext *ctx, uint32_t num_views, View const *views) const
+{
+	void **commands = FrameAllocator::get()->alloc<void*>(material_count);
+	for (uint32_t i(0); i < material_count; i++)
 	{
-		merge_cmd_data data = {pairs + cmd_count, contexts + i};
-		JobSystem::run(merge_cmd, &data, &counter);
-		cmd_count += contexts[i].cmd_count();
-	}
-	JobSystem::wait(&counter, worker_count);
+		auto *cmd = ctx->create<DrawElements>();
+		commands[i] = cmd;
+
+		cmd->model = model;
+		cmd->vao = vao;
+		memcpy(&(cmd->submesh), submeshes + i, sizeof(Submesh));
 	}
 
-	// Sort
-	{ MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "sort commands");
-	std::sort(pairs, pairs + cmd_count);
+	for (uint32_t view_id(0) ; view_id < num_views; ++view_id)
+	{
+		const View &view = views[view_id];
+
+		vec4 pos = view.vp * vec4(position, 1.0f);
+		float depth = pos.z / pos.w;
+
+		for (uint32_t i(0); i < material_count; i++)
+		{
+			if (!materials[i]->has_pass(view.pass))
+				continue;
+
+			uint64_t key = CommandKey::encode(view_id, view.pass, materials[i]->get_id(), depth);
+			ctx->add(key, commands[i]);
+		}
 	}
+}
+
+void GraphicEngine::sort()
+{
+	MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "sort");
+
+	pairs = RenderContext::sort(contexts, JobSystem::worker_count(), pair_count);
+}
+
+void GraphicEngine::submit()
+{
+	MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "submit");
 
 	// Submit to backend
-	{ MICROPROFILE_SCOPEI("SYSTEM_GRAPHIC", "submit commands");
-	auto *last = pairs + cmd_count;
+	auto *last = pairs + pair_count;
 	for (auto *pair = pairs; pair < last; pair++)
 		CommandPacket::submit(pair->key, pair->packet);
-	}
-
-	delete[] pairs;
+	pair_count = 0;
 
 	GL::BindFramebuffer(0);
 
+	// No command references retired resources anymore
+	std::lock_guard<std::mutex> guard(retiredLock);
+	retired.clear();
+}
+
+void GraphicEngine::retire(std::shared_ptr<void> _resource)
+{
+	if (_resource == nullptr)
+		return;
+
+	std::lock_guard<std::mutex> guard(retiredLock);
+	retired.push_back(std::move(_resource));
+}
+
+void GraphicEngine::finish()
+{
 #ifdef DRAWAABB
 	for(Graphic* g: graphics)
 		g->getAABB().prepare();
@@ -173,6 +217,4 @@ void GraphicEngine::render()
 #ifdef DEBUG
 	Debug::update();
 #endif
-
-	//glDisable(GL_SCISSOR_TEST);
 }
@@ -0,0 +1,423 @@
+#include "Snapshot.h"
+
+#include "Components/Transform.h"
+#include "Components/RigidBody.h"
+#include "Components/Light.h"
+#include "Components/Box.h"
+#include "Components/Sphere.h"
+#include "Components/Cylinder.h"
+#include "Components/Cone.h"
+
+#include "Profiler/profiler.h"
+
+#include <cstdio>
+#include <map>
+#include <tuple>
+
+static const uint32_t MAGIC = 0x5353474d; // "MGSS"
+static const uint32_t VERSION = 1;
+static const uint32_t NONE = ~0u;
+
+static void saveCollider(const Collider* _collider, Snapshot::Writer& _writer)
+{
+	_writer.write(_collider->getCenter());
+	_writer.write<uint8_t>(_collider->getTrigger());
+	_writer.write(_collider->getRestitution());
+	_writer.write(_collider->getDynamicFriction());
+	_writer.write(_collider->getStaticFriction());
+}
+
+static void loadCollider(Snapshot::Reader& _reader, vec3& _center, bool& _trigger, PhysicMaterialRef& _material)
+{
+	_center = _reader.read<vec3>();
+	_trigger = _reader.read<uint8_t>() != 0;
+
+	float restitution = _reader.read<float>();
+	float dynamicFriction = _reader.read<float>();
+	float staticFriction = _reader.read<float>();
+
+	// Colliders sharing a material in the file share it once loaded
+	PhysicMaterialRef& material = _reader.cache->materials[std::make_tuple(restitution, dynamicFriction, staticFriction)];
+	if (material == nullptr)
+		material = PhysicMaterial::create(restitution, dynamicFriction, staticFriction);
+
+	_material = material;
+}
+
+/// Methods (static)
+bool Snapshot::save(const std::string& _path)
+{
+	MICROPROFILE_SCOPEI("ENGINE", "snapshot save");
+
+	const std::vector<Entity*>& entities = Entity::entities;
+
+	Writer writer;
+	writer.write(MAGIC);
+	writer.write(VERSION);
+
+	// Tags
+	std::vector<uint32_t> tagIndices(Tag::getCount(), NONE);
+	std::vector<std::string> tags;
+
+	for (Entity* e: entities)
+	{
+		uint32_t& index = tagIndices[e->tag.getId()];
+		if (index == NONE)
+		{
+			index = tags.size();
+			tags.push_back(e->tag.toString());
+		}
+	}
+
+	writer.write<uint32_t>(tags.size());
+	for (const std::string& tag: tags)
+		writer.write(tag);
+
+	// Entities, then their transforms
+	writer.write<uint32_t>(entities.size());
+	for (Entity* e: entities)
+	{
+		Transform* parent = e->tr->getParent();
+
+		writer.write<uint32_t>(tagIndices[e->tag.getId()]);
+		writer.write<uint8_t>(e->prototype);
+		writer.write<uint32_t>(parent ? parent->getEntity()->index : NONE);
+	}
+
+	for (Entity* e: entities)
+	{
+		Entity::Placement placement{e->tr->position, e->tr->rotation, e->tr->scale};
+		writer.write(placement);
+	}
+
+	// Components, one block per type
+	std::vector<Writer> blocks;
+	std::vector<std::pair<const Serializer*, uint32_t>> headers;
+	size_t saved = 0;
+
+	for (const Serializer& serializer: serializers())
+	{
+		Writer block;
+		uint32_t count = 0;
+
+		for (Archetype* archetype: Archetype::all())
+		{
+			unsigned first = archetype->find(serializer.key);
+			if (first == Archetype::npos)
+				continue;
+
+			unsigned last = first + archetype->count(serializer.key);
+			for (unsigned chunk(0) ; chunk < archetype->getChunkCount() ; chunk++)
+			{
+				Entity** owners = archetype->entities(chunk);
+				unsigned size = archetype->getChunkSize(chunk);
+
+				for (unsigned column(first) ; column < last ; column++)
+				{
+					Component** components = archetype->column(chunk, column);
+					for (unsigned i(0) ; i < size ; i++)
+					{
+						if (components[i] == nullptr || components[i]->getType() != serializer.type)
+							continue;
+
+						block.write<uint32_t>(owners[i]->index);
+						serializer.save(components[i], block);
+						count++;
+					}
+				}
+			}
+		}
+
+		if (count != 0)
+		{
+			blocks.push_back(std::move(block));
+			headers.emplace_back(&serializer, count);
+			saved += count;
+		}
+	}
+
+	size_t total = 0;
+	for (Archetype* archetype: Archetype::all())
+		total += archetype->getSize() * archetype->getColumns();
+
+	if (total != saved)
+		Error::add(Error::WARNING, "Snapshot::save() -> " + toString(total - saved) + " components have no serializer and were not saved");
+
+	writer.write<uint32_t>(blocks.size());
+	for (size_t i(0) ; i < blocks.size() ; i++)
+	{
+		writer.write(headers[i].first->name);
+		writer.write<uint32_t>(headers[i].second);
+		writer.write<uint64_t>(blocks[i].data.size()); // to skip unknown types
+		writer.write(blocks[i].data.data(), blocks[i].data.size());
+	}
+
+	FILE* file = fopen(_path.c_str(), "wb");
+	if (file == nullptr)
+	{
+		Error::add(Error::FILE_NOT_FOUND, "Snapshot::save() -> Unable to open " + _path);
+		return false;
+	}
+
+	bool written = fwrite(writer.data.data(), 1, writer.data.size(), file) == writer.data.size();
+	return (fclose(file) == 0) && written;
+}
+
+std::vector<Entity*> Snapshot::load(const std::string& _path)
+{
+	MICROPROFILE_SCOPEI("ENGINE", "snapshot load");
+
+	std::vector<Entity*> entities;
+
+	// Read the whole file at once
+	FILE* file = fopen(_path.c_str(), "rb");
+	if (file == nullptr)
+	{
+		Error::add(Error::FILE_NOT_FOUND, "Snapshot::load() -> Unable to open " + _path);
+		return entities;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	std::vector<uint8_t> buffer(size > 0 ? size : 0);
+	bool read = fread(buffer.data(), 1, buffer.size(), file) == buffer.size();
+	fclose(file);
+
+	Reader::Cache cache;
+	Reader reader{buffer.data(), buffer.data() + buffer.size(), !read, &cache};
+
+	if (reader.read<uint32_t>() != MAGIC || reader.read<uint32_t>() != VERSION)
+	{
+		Error::add(Error::USER, "Snapshot::load() -> " + _path + " is not a snapshot or has an old version");
+		return entities;
+	}
+
+	// Tags
+	std::vector<std::string> tags;
+	uint32_t tagCount = reader.read<uint32_t>();
+	for (uint32_t i(0) ; i < tagCount && !reader.failed ; i++)
+		tags.push_back(reader.readString());
+
+	// Entities, then their transforms
+	struct Record
+	{
+		uint32_t tag;
+		bool prototype;
+		uint32_t parent;
+	};
+
+	uint32_t count = reader.read<uint32_t>();
+	if (reader.failed || count > buffer.size())
+	{
+		count = 0;
+		reader.failed = true;
+	}
+
+	std::vector<Record> records(count);
+	for (Record& r: records)
+	{
+		r.tag = reader.read<uint32_t>();
+		r.prototype = reader.read<uint8_t>() != 0;
+		r.parent = reader.read<uint32_t>();
+
+		if (r.tag >= tags.size() || (r.parent != NONE && r.parent >= count))
+			reader.failed = true;
+	}
+
+	std::vector<Entity::Placement> placements(count);
+	reader.read(placements.data(), count * sizeof(Entity::Placement));
+
+	if (reader.failed)
+	{
+		Error::add(Error::USER, "Snapshot::load() -> " + _path + " is corrupted");
+		return entities;
+	}
+
+	reserveMore(Entity::entities, count);
+	entities.reserve(count);
+
+	for (uint32_t i(0) ; i < count ; i++)
+	{
+		const Entity::Placement& p = placements[i];
+		entities.push_back(Entity::create(tags[records[i].tag], records[i].prototype, p.position, p.rotation, p.scale));
+	}
+
+	for (uint32_t i(0) ; i < count ; i++)
+	{
+		if (records[i].parent != NONE)
+			entities[i]->tr->setParent(entities[records[i].parent]->tr);
+	}
+
+	// Components, registered type by type
+	std::vector<uint32_t> owners;
+	std::vector<Component*> components;
+
+	uint32_t blocks = reader.read<uint32_t>();
+	for (uint32_t b(0) ; b < blocks && !reader.failed ; b++)
+	{
+		std::string name = reader.readString();
+
+		uint32_t components_count = reader.read<uint32_t>();
+		uint64_t bytes = reader.read<uint64_t>();
+
+		if (reader.failed || bytes > uint64_t(reader.end - reader.data))
+		{
+			reader.failed = true;
+			break;
+		}
+
+		Reader block{reader.data, reader.data + bytes, false, &cache};
+		reader.data += bytes;
+
+		const Serializer* serializer = nullptr;
+		for (const Serializer& s: serializers())
+			if (s.name == name) serializer = &s;
+
+		if (serializer == nullptr)
+		{
+			Error::add(Error::WARNING, "Snapshot::load() -> No serializer for " + name + ", components are skipped");
+			continue;
+		}
+
+		owners.clear();
+		components.clear();
+
+		for (uint32_t i(0) ; i < components_count ; i++)
+		{
+			uint32_t owner = block.read<uint32_t>();
+			Component* c = block.failed ? nullptr : serializer->load(block);
+
+			if (c == nullptr || block.failed || owner >= count)
+			{
+				delete c;
+				block.failed = true;
+				break;
+			}
+
+			owners.push_back(owner);
+			components.push_back(c);
+		}
+
+		reader.failed = block.failed;
+
+		if (components.empty())
+			continue;
+
+		// Components of prototypes are not registered
+		size_t registered = 0;
+		for (uint32_t owner: owners)
+			registered += !entities[owner]->prototype;
+
+		if (registered)
+			components.front()->onReserve(registered);
+
+		for (size_t i(0) ; i < components.size() ; i++)
+			entities[owners[i]]->insertComponent(components[i], serializer->type, serializer->key);
+	}
+
+	if (reader.failed)
+		Error::add(Error::USER, "Snapshot::load() -> " + _path + " is corrupted, some components were not loaded");
+
+	return entities;
+}
+
+/// Methods (private)
+std::vector<Snapshot::Serializer>& Snapshot::serializers()
+{
+	static std::vector<Serializer> serializers;
+	static bool builtins = false;
+
+	if (!builtins)
+	{
+		builtins = true;
+		addBuiltins();
+	}
+
+	return serializers;
+}
+
+void Snapshot::addBuiltins()
+{
+	add<RigidBody>("RigidBody",
+		[](const Component* _c, Writer& _w) {
+			_w.write(static_cast<const RigidBody*>(_c)->getDensity());
+		},
+		[](Reader& _r) -> Component* {
+			return create<RigidBody>(_r.read<float>());
+		}
+	);
+
+	add<Light>("Light",
+		[](const Component* _c, Writer& _w) {
+			const Light* l = static_cast<const Light*>(_c);
+			_w.write<uint32_t>(l->getLightType());
+			_w.write(l->getColor());
+			_w.write<uint8_t>(l->getCastShadow());
+		},
+		[](Reader& _r) -> Component* {
+			uint32_t type = _r.read<uint32_t>();
+			vec3 color = _r.read<vec3>();
+			bool shadow = _r.read<uint8_t>() != 0;
+
+			if (type > Light::Directional)
+				return nullptr;
+			return create<Light>((Light::Type)type, color, shadow);
+		}
+	);
+
+	add<Box>("Box",
+		[](const Component* _c, Writer& _w) {
+			const Box* b = static_cast<const Box*>(_c);
+			_w.write(b->halfExtent);
+			saveCollider(b, _w);
+		},
+		[](Reader& _r) -> Component* {
+			vec3 halfExtent = _r.read<vec3>(), center; bool trigger; PhysicMaterialRef material;
+			loadCollider(_r, center, trigger, material);
+			return create<Box>(halfExtent, center, material, trigger);
+		}
+	);
+
+	add<Sphere>("Sphere",
+		[](const Component* _c, Writer& _w) {
+			const Sphere* s = static_cast<const Sphere*>(_c);
+			_w.write(s->radius);
+			saveCollider(s, _w);
+		},
+		[](Reader& _r) -> Component* {
+			float radius = _r.read<float>(); vec3 center; bool trigger; PhysicMaterialRef material;
+			loadCollider(_r, center, trigger, material);
+			return create<Sphere>(radius, center, material, trigger);
+		}
+	);
+
+	add<Cylinder>("Cylinder",
+		[](const Component* _c, Writer& _w) {
+			const Cylinder* c = static_cast<const Cylinder*>(_c);
+			_w.write(c->radius);
+			_w.write(c->height);
+			saveCollider(c, _w);
+		},
+		[](Reader& _r) -> Component* {
+			float radius = _r.read<float>(), height = _r.read<float>(); vec3 center; bool trigger; PhysicMaterialRef material;
+			loadCollider(_r, center, trigger, material);
+			return create<Cylinder>(radius, height, center, material, trigger);
+		}
+	);
+
+	add<Cone>("Cone",
+		[](const Component* _c, Writer& _w) {
+			const Cone* c = static_cast<const Cone*>(_c);
+			_w.write(c->radius);
+			_w.write(c->height);
+			saveCollider(c, _w);
+		},
+		[](Reader& _r) -> Component* {
+			float radius = _r.read<float>(), height = _r.read<float>(); vec3 center; bool trigger; PhysicMaterialRef material;
+			loadCollider(_r, center, trigger, material);
+			return create<Cone>(radius, height, center, material, trigger);
+		}
+	);
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Entity.h"
+#include "Assets/PhysicMaterial.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <map>
+
+// Binary copy of the entities of the world, for fast level loading
+// The file is made of contiguous blocks: tags, entities (tag, prototype flag, parent), transforms,
+// then one block per component type holding, for each component, the index of its entity followed
+// by the data written by the serializer of that type.
+// Saved: transforms, RigidBody, Light, Box, Sphere, Cylinder, Cone and the types given to add().
+// Skipped: Graphic, Animator, Skybox, Camera, AudioListener and scripts. Meshes, materials and render
+// targets have no persistent name to reference them by, and scripts hold arbitrary state. save() warns
+// when components are skipped.
+class Snapshot
+{
+public:
+	struct Writer
+	{
+		template <typename T>
+		void write(const T& _value)
+		{ write(&_value, sizeof(T)); }
+
+		void write(const void* _data, size_t _size)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(_data);
+			data.insert(data.end(), bytes, bytes + _size);
+		}
+
+		void write(const std::string& _string)
+		{
+			write<uint32_t>(_string.size());
+			write(_string.data(), _string.size());
+		}
+
+		std::vector<uint8_t> data;
+	};
+
+	struct Reader
+	{
+		// Shared by the readers of one load
+		struct Cache
+		{
+			std::map<std::tuple<float, float, float>, PhysicMaterialRef> materials;
+		};
+
+		template <typename T>
+		T read()
+		{
+			T value = T();
+			read(&value, sizeof(T));
+			return value;
+		}
+
+		void read(void* _data, size_t _size)
+		{
+			if (failed || size_t(end - data) < _size)
+			{
+				failed = true;
+				return;
+			}
+
+			memcpy(_data, data, _size);
+			data += _size;
+		}
+
+		std::string readString()
+		{
+			uint32_t size = read<uint32_t>();
+			if (failed || size > size_t(end - data))
+			{
+				failed = true;
+				return std::string();
+			}
+
+			data += size;
+			return std::string(reinterpret_cast<const char*>(data - size), size);
+		}
+
+		const uint8_t *data, *end;
+		bool failed;
+		Cache* cache;
+	};
+
+	typedef void (*Save)(const Component* _component, Writer& _writer);
+	typedef Component* (*Load)(Reader& _reader);
+
+	/// Methods (static)
+	// _name identifies the type in files, it must not change between builds
+	template <typename T>
+	static void add(const std::string& _name, Save _save, Load _load)
+	{
+		unsigned type = ComponentType::id<T>();
+		unsigned key = std::is_base_of<Collider, T>::value ? Entity::getColliderId() : type;
+
+		serializers().push_back({_name, type, key, _save, _load});
+	}
+
+	// Load functions allocate with create<T>, from the pool of the type like Entity::insert
+	template <typename T, typename... Args>
+	static T* create(Args&&... _args)
+	{
+		static_assert(alignof(T) <= ObjectPool::ALIGNMENT, "Components are allocated with ObjectPool::ALIGNMENT");
+
+		return new (Entity::getPool<T>()) T(std::forward<Args>(_args)...);
+	}
+
+	static bool save(const std::string& _path);
+	static std::vector<Entity*> load(const std::string& _path); // returns the loaded entities
+
+private:
+	struct Serializer
+	{
+		std::string name;
+		unsigned type, key;
+
+		Save save;
+		Load load;
+	};
+
+	/// Methods (private)
+	static std::vector<Serializer>& serializers(); // built-in components are added on first use
+	static void addBuiltins();
+};
@@ -61,6 +61,14 @@ void GraphicEngine::clear()
 	graphics.clear();
 	cameras.clear();
 	lights.clear();
+
+	drawables = nullptr;
+	drawable_count = 0;
+	view_count = 0;
+
+	pairs = nullptr;
+	pair_count = 0;
+	retired.clear();
 }
 
 /// Methods (static)
@@ -86,14 +94,26 @@ GraphicEngine* GraphicEngine::get()
 /// Methods (public)
 void GraphicEngine::addAnimator(Animator* _animator)
 {
+	_animator->index = animators.size();
 	animators.push_back(_animator);
 }
 
 void GraphicEngine::addGraphic(Graphic* _graphic)
 {
+	_graphic->index = graphics.size();
 	graphics.push_back(_graphic);
 }
 
+void GraphicEngine::reserveAnimators(unsigned _count)
+{
+	reserveMore(animators, _count);
+}
+
+void GraphicEngine::reserveGraphics(unsigned _count)
+{
+	reserveMore(graphics, _count);
+}
+
 void GraphicEngine::addCamera(Camera* _camera)
 {
 	if (cameras.size() == MAX_VIEWS)
@@ -108,27 +128,30 @@ void GraphicEngine::addLight(Light* _light)
 	if (Light::main == nullptr && _light->type == Light::Directional)
 		Light::main = _light;
 
+	_light->index = lights.size();
 	lights.push_back(_light);
 }
 
 void GraphicEngine::removeAnimator(Animator* _animator)
 {
-	auto it = std::find(animators.begin(), animators.end(), _animator);
-	if (it != animators.end())
-	{
-		*it = animators.back();
-		animators.pop_back();
-	}
+	if (_animator->index >= animators.size() || animators[_animator->index] != _animator)
+		return;
+
+	Animator* last = animators.back();
+	last->index = _animator->index;
+	animators[_animator->index] = last;
+	animators.pop_back();
 }
 
 void GraphicEngine::removeGraphic(Graphic* _graphic)
 {
-	auto it = std::find(graphics.begin(), graphics.end(), _graphic);
-	if (it != graphics.end())
-	{
-		*it = graphics.back();
-		graphics.pop_back();
-	}
+	if (_graphic->index >= graphics.size() || graphics[_graphic->index] != _graphic)
+		return;
+
+	Graphic* last = graphics.back();
+	last->index = _graphic->index;
+	graphics[_graphic->index] = last;
+	graphics.pop_back();
 }
 
 void GraphicEngine::removeCamera(Camera* _camera)
@@ -141,12 +164,13 @@ void GraphicEngine::removeCamera(Camera* _camera)
 
 void GraphicEngine::removeLight(Light* _light)
 {
-	auto it = std::find(lights.begin(), lights.end(), _light);
-	if (it != lights.end())
-	{
-		*it = lights.back();
-		lights.pop_back();
-	}
+	if (_light->index >= lights.size() || lights[_light->index] != _light)
+		return;
+
+	Light* last = lights.back();
+	last->index = _light->index;
+	lights[_light->index] = last;
+	lights.pop_back();
 
 	if (Light::main == _light)
 	{
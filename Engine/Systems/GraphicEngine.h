@@ -5,6 +5,9 @@
 
 #include "Utility/helpers.h"
 
+#include <memory>
+#include <mutex>
+
 
 #define BUFFER_OFFSET(offset) ((char*)nullptr + (offset))
 
@@ -25,6 +28,20 @@ struct View
 	RenderPass::Type pass;
 };
 
+// Copy of what is needed to draw a Graphic, taken at the end of a simulation step
+struct Drawable
+{
+	mat4 model;
+	vec3 position;
+
+	unsigned vao;
+	const struct Submesh *submeshes;
+	const Material **materials; // kept alive by GraphicEngine::retire
+	uint32_t material_count;
+
+	void render(RenderContext *ctx, uint32_t num_views, View const *views) const;
+};
+
 class GraphicEngine
 {
 	friend class Engine;
@@ -39,6 +56,9 @@ public:
 	void addCamera(Camera* _camera);
 	void addLight(Light* _light);
 
+	void reserveAnimators(unsigned _count);
+	void reserveGraphics(unsigned _count);
+
 	void removeAnimator(Animator* _animator);
 	void removeGraphic(Graphic* _graphic);
 	void removeCamera(Camera* _camera);
@@ -49,6 +69,18 @@ public:
 	void toggleWireframe();
 	void render();
 
+	// render() is split in steps so that the engine can overlap the front-end with the next simulation step
+	void sample();	// advance animations, only writes animators
+	void animate();	// update skeletons, writes bone transforms
+	void snapshot();	// copy views and drawables on the main thread, reads the scene
+	void prepare();	// generate commands, only reads the snapshot
+	void sort();	// merge and sort commands, only reads commands
+	void submit();	// submit commands on the main thread, then release retired resources
+	void finish();	// debug drawing, reads the scene
+
+	// Keep a resource alive until the commands generated before now are submitted
+	void retire(std::shared_ptr<void> _resource);
+
 	/// Getters
 	Light* getLight(uint32_t id) const
 	{ return lights[id]; }
@@ -74,6 +106,16 @@ private:
 	View views[MAX_VIEWS];
 	RenderContext *contexts;
 
+	Drawable *drawables = nullptr; // taken by snapshot(), valid until the end of the next frame
+	size_t drawable_count = 0;
+	uint32_t view_count = 0;
+
+	RenderContext::CommandPair *pairs = nullptr; // sorted, valid until the end of the next frame
+	size_t pair_count = 0;
+
+	std::vector<std::shared_ptr<void>> retired;
+	std::mutex retiredLock;
+
 	bool wireframe = false;
 
 	/// Attributes (static)
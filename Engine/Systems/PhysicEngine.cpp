@@ -3,6 +3,7 @@
 #include "Components/Transform.h"
 #include "Components/RigidBody.h"
 #include "Components/Collider.h"
+#include "Components/Script.h"
 
 #include "Physic/Constraint.h"
 #include "Physic/DistanceConstraint.h"
@@ -19,7 +20,8 @@ PhysicEngine* PhysicEngine::instance = nullptr;
 /// Methods (private)
 PhysicEngine::PhysicEngine(vec3 _gravity):
 	maxIterations(15),
-	accumulator(0.0f), dt(1.0f / 60.0f)
+	accumulator(0.0f), dt(1.0f / 60.0f),
+	version(0)
 {
 	Dispatcher::fill();
 	setGravity(_gravity);
@@ -35,6 +37,7 @@ void PhysicEngine::clear()
 	bodies.clear();
 	colliders.clear();
 	constraints.clear();
+	events.clear();
 
 	DistanceConstraint::clear();
 }
@@ -63,7 +66,10 @@ PhysicEngine* PhysicEngine::get()
 void PhysicEngine::addRigidBody(RigidBody* _body)
 {
 	if (_body != nullptr)
+	{
+		_body->index = bodies.size();
 		bodies.push_back(_body);
+	}
 }
 
 void PhysicEngine::addCollider(Collider* _collider)
@@ -71,6 +77,7 @@ void PhysicEngine::addCollider(Collider* _collider)
 	if (_collider != nullptr)
 	{
 		_collider->computeAABB();
+		_collider->index = colliders.size();
 		colliders.push_back(_collider);
 	}
 }
@@ -78,37 +85,53 @@ void PhysicEngine::addCollider(Collider* _collider)
 void PhysicEngine::addConstraint(Constraint* _constraint)
 {
 	if (_constraint != nullptr)
+	{
+		_constraint->index = constraints.size();
 		constraints.push_back(_constraint);
+	}
+}
+
+void PhysicEngine::reserveRigidBodies(unsigned _count)
+{
+	reserveMore(bodies, _count);
+}
+
+void PhysicEngine::reserveColliders(unsigned _count)
+{
+	reserveMore(colliders, _count);
 }
 
 void PhysicEngine::removeRigidBody(RigidBody* _body)
 {
-	auto it = std::find(bodies.begin(), bodies.end(), _body);
-	if (it != bodies.end())
-	{
-		*it = bodies.back();
-		bodies.pop_back();
-	}
+	if (_body->index >= bodies.size() || bodies[_body->index] != _body)
+		return;
+
+	RigidBody* last = bodies.back();
+	last->index = _body->index;
+	bodies[_body->index] = last;
+	bodies.pop_back();
 }
 
 void PhysicEngine::removeCollider(Collider* _collider)
 {
-	auto it = std::find(colliders.begin(), colliders.end(), _collider);
-	if (it != colliders.end())
-	{
-		*it = colliders.back();
-		colliders.pop_back();
-	}
+	if (_collider->index >= colliders.size() || colliders[_collider->index] != _collider)
+		return;
+
+	Collider* last = colliders.back();
+	last->index = _collider->index;
+	colliders[_collider->index] = last;
+	colliders.pop_back();
 }
 
 void PhysicEngine::removeConstraint(Constraint* _constraint)
 {
-	auto it = std::find(constraints.begin(), constraints.end(), _constraint);
-	if (it != constraints.end())
-	{
-		*it = constraints.back();
-		constraints.pop_back();
-	}
+	if (_constraint->index >= constraints.size() || constraints[_constraint->index] != _constraint)
+		return;
+
+	Constraint* last = constraints.back();
+	last->index = _constraint->index;
+	constraints[_constraint->index] = last;
+	constraints.pop_back();
 }
 
 void PhysicEngine::simulate()
@@ -165,9 +188,15 @@ void PhysicEngine::update()
 		body->integrateVelocities(dt);
 	}
 
+	// Only colliders that moved or changed shape need a new AABB
+	uint32_t since = version;
+	version = ComponentType::tick();
+
+	bool moved = ComponentType::getVersion(ComponentType::id<Transform>()) > since;
 	for (Collider* collider: colliders)
 	{
-		collider->computeAABB();
+		if ((moved && collider->tr->getVersion() > since) || collider->getVersion() > since)
+			collider->computeAABB();
 #ifdef DRAWAABB
 		collider->getAABB()->prepare();
 #endif
@@ -228,38 +257,57 @@ void PhysicEngine::detectCollision(Collider* a, Collider* b)
 		return;
 
 
-	ContactConstraint* contact = new ContactConstraint(a, b);
+	auto marker = contacts.getMarker();
+	void *data = contacts.alloc(sizeof(ContactConstraint), alignof(ContactConstraint));
+	ContactConstraint* contact = new (data) ContactConstraint(a, b);
 
-	if (!contact->positionConstraint())	// not colliding
-		delete contact;
-	else
+	if (!contact->positionConstraint() || contact->type != 0)	// not colliding or trigger
 	{
-		if (contact->type == 0)
-			collisions.push_back(contact);
-		else
-			delete contact;
-//			triggers.push_back(contact);
+		contact->~ContactConstraint();
+		contacts.freeToMarker(marker);
 	}
+	else
+		collisions.push_back(contact);
+//		triggers.push_back(contact);
 }
 
 void PhysicEngine::sendAndFreeData()
 {
 	activeConstraints.clear();
 
-	// Send to scripts and clear arrays
+	// Queue callbacks and clear arrays
 	for (ContactConstraint* trigger: triggers)
 	{
-		trigger->sendData();
-		delete trigger;
+		trigger->sendData(events);
+		trigger->~ContactConstraint();
 	}
 	triggers.clear();
 
 	for (ContactConstraint* collision: collisions)
 	{
-		collision->sendData();
-		delete collision;
+		collision->sendData(events);
+		collision->~ContactConstraint();
 	}
 	collisions.clear();
+
+	contacts.clear();
+}
+
+void PhysicEngine::sendEvents()
+{
+	MICROPROFILE_SCOPEI("SYSTEM_PHYSIC", "send events");
+
+	for (const ContactEvent& event: events)
+	{
+		for (Script* script: event.receiver->findAll<Script>())
+		{
+			if (event.trigger)
+				script->onTrigger(event.collision.collider);
+			else
+				script->onCollision(event.collision);
+		}
+	}
+	events.clear();
 }
 
 void PhysicEngine::setGravity(vec3 _gravity)
@@ -1,7 +1,10 @@
 #ifndef PHYSICENGINE_H
 #define PHYSICENGINE_H
 
+#include "Physic/ContactConstraint.h"
+
 #include "Utility/helpers.h"
+#include "Utility/Memory/StackAllocator.h"
 
 class RigidBody;
 class Collider;
@@ -23,6 +26,9 @@ class PhysicEngine
 			void addCollider(Collider* _collider);
 			void addConstraint(Constraint* _constraint);
 
+			void reserveRigidBodies(unsigned _count);
+			void reserveColliders(unsigned _count);
+
 			void removeRigidBody(RigidBody* _body);
 			void removeCollider(Collider* _collider);
 			void removeConstraint(Constraint* _constraint);
@@ -30,6 +36,9 @@ class PhysicEngine
 			void simulate();
 			void update();
 
+			// Collision and trigger callbacks of the last steps, they run script code
+			void sendEvents();
+
 			RayHit raycast(vec3 _origin, vec3 _direction);
 			std::vector<RayHit> raycastAll(vec3 _origin, vec3 _direction, bool _sort = false);
 
@@ -56,6 +65,8 @@ class PhysicEngine
 			std::vector<Constraint*> activeConstraints;
 			std::vector<ContactConstraint*> triggers;
 			std::vector<ContactConstraint*> collisions;
+			StackAllocator<16384> contacts{120}; // storage of triggers and collisions
+			std::vector<ContactEvent> events;
 
 			vec3 gravity;
 			float gravityValue;
@@ -64,6 +75,8 @@ class PhysicEngine
 			float accumulator;
 			float dt;
 
+			uint32_t version; // of the last AABB update
+
 		/// Attributes (static)
 			static PhysicEngine* instance;
 };
@@ -0,0 +1,167 @@
+#include "Systems/Scheduler.h"
+
+#include "Utility/JobSystem/JobSystem.h"
+#include "Profiler/profiler.h"
+
+#include <chrono>
+
+Scheduler* Scheduler::instance = nullptr;
+
+Scheduler::System::System(const char *_name, Update _update):
+	name(_name), update(_update), exclusive(false), main_thread(false),
+	dependencies(0), pending(0), ready(false), time(0.0f), token(0)
+{
+#if MICROPROFILE_ENABLED
+	token = MicroProfileGetToken("SYSTEMS", name, -1, MicroProfileTokenTypeCpu);
+#endif
+}
+
+bool Scheduler::System::conflicts(const System *_other) const
+{
+	if (exclusive || _other->exclusive)
+		return true;
+
+	return (writes & (_other->writes | _other->reads)).any()
+		|| (reads & _other->writes).any();
+}
+
+/// Methods (private)
+Scheduler::Scheduler():
+	done(0), dirty(false)
+{ }
+
+Scheduler::~Scheduler()
+{
+	for (System *system: systems)
+		delete system;
+}
+
+void Scheduler::build()
+{
+	main_systems.clear();
+	for (System *system: systems)
+	{
+		system->dependents.clear();
+		system->dependencies = 0;
+
+		if (system->main_thread)
+			main_systems.push_back(system);
+	}
+
+	// A system waits for every previously added system it conflicts with
+	for (size_t j(1); j < systems.size(); j++)
+	{
+		for (size_t i(0); i < j; i++)
+		{
+			if (!systems[i]->conflicts(systems[j]))
+				continue;
+
+			systems[i]->dependents.push_back(systems[j]);
+			systems[j]->dependencies++;
+		}
+	}
+
+	dirty = false;
+}
+
+void Scheduler::launch(System *_system)
+{
+	if (_system->main_thread)
+		_system->ready.store(true, std::memory_order_release);
+	else
+		JobSystem::run(job, &_system, sizeof(_system));
+}
+
+void Scheduler::execute(System *_system)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	{ MICROPROFILE_SCOPE_TOKEN(_system->token);
+		_system->update();
+	}
+
+	std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	_system->time = elapsed.count();
+
+	for (System *dependent: _system->dependents)
+	{
+		if (dependent->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			launch(dependent);
+	}
+
+	done.fetch_add(1, std::memory_order_release);
+}
+
+void Scheduler::job(const void *_system)
+{
+	System *system = *static_cast<System* const*>(_system);
+	instance->execute(system);
+}
+
+/// Methods (static)
+void Scheduler::create()
+{
+	if (instance != nullptr)
+		return;
+
+	instance = new Scheduler();
+}
+
+void Scheduler::destroy()
+{
+	delete instance;
+	instance = nullptr;
+}
+
+Scheduler* Scheduler::get()
+{
+	return instance;
+}
+
+/// Methods (public)
+Scheduler::System* Scheduler::add(const char *_name, Update _update)
+{
+	System *system = new System(_name, _update);
+	systems.push_back(system);
+
+	dirty = true;
+	return system;
+}
+
+void Scheduler::run()
+{
+	MICROPROFILE_SCOPEI("SYSTEMS", "run");
+
+	if (dirty)
+		build();
+
+	done.store(0, std::memory_order_relaxed);
+	for (System *system: systems)
+	{
+		system->pending.store(system->dependencies, std::memory_order_relaxed);
+		system->ready.store(false, std::memory_order_relaxed);
+	}
+
+	for (System *system: systems)
+	{
+		if (system->dependencies == 0)
+			launch(system);
+	}
+
+	// Run main thread systems as they become ready, help the workers otherwise
+	while (done.load(std::memory_order_acquire) != systems.size())
+	{
+		bool found = false;
+		for (System *system: main_systems)
+		{
+			if (system->ready.exchange(false, std::memory_order_acquire))
+			{
+				execute(system);
+				found = true;
+			}
+		}
+
+		if (!found)
+			JobSystem::yield();
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "ComponentType.h"
+
+#include <cstdint>
+#include <bitset>
+#include <atomic>
+#include <vector>
+
+// Runs systems as a dependency graph on the job system
+// Each system declares the component types it reads and writes. Two systems conflict
+// if one writes a type the other accesses, conflicting systems run in registration
+// order while the others may run concurrently on any worker.
+class Scheduler
+{
+	friend class Engine;
+
+public:
+	typedef void (*Update)();
+
+	class System
+	{
+		friend class Scheduler;
+
+	public:
+		template <typename T> System* read()
+		{
+			reads.set(ComponentType::id<T>());
+			invalidate();
+			return this;
+		}
+
+		template <typename T> System* write()
+		{
+			writes.set(ComponentType::id<T>());
+			invalidate();
+			return this;
+		}
+
+		// Conflicts with every other system, for code that can touch anything (scripts)
+		System* writeAll()	{ exclusive = true; invalidate(); return this; }
+
+		// Run on the thread calling Scheduler::run
+		System* mainThread()	{ main_thread = true; invalidate(); return this; }
+
+		const char *getName() const	{ return name; }
+		float getTime() const		{ return time; } // in milliseconds, during the last run
+
+	private:
+		System(const char *_name, Update _update);
+
+		bool conflicts(const System *_other) const;
+		void invalidate() { instance->dirty = true; } // graph is rebuilt on next run
+
+		const char *name;
+		Update update;
+
+		std::bitset<ComponentType::MAX> reads, writes;
+		bool exclusive, main_thread;
+
+		std::vector<System*> dependents;
+		unsigned dependencies;
+		std::atomic<unsigned> pending;
+		std::atomic<bool> ready;
+
+		float time;
+		uint64_t token;
+	};
+
+	/// Methods (static)
+	static Scheduler* get();
+
+	/// Methods (public)
+	System* add(const char *_name, Update _update); // not while running
+	void run();
+
+	/// Getters
+	const std::vector<System*>& getSystems() const	{ return systems; }
+
+private:
+	/// Methods (private)
+	Scheduler();
+	~Scheduler();
+
+	void build();
+	void launch(System *_system);
+	void execute(System *_system);
+
+	static void job(const void *_system);
+
+	static void create();
+	static void destroy();
+
+	/// Attributes (private)
+	std::vector<System*> systems;
+	std::vector<System*> main_systems;
+	std::atomic<unsigned> done;
+	bool dirty;
+
+	/// Attributes (static)
+	static Scheduler* instance;
+};
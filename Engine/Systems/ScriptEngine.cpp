@@ -2,13 +2,32 @@
 
 #include "Components/Script.h"
 #include "Entity.h"
+#include "EntityCommandBuffer.h"
 
+#include "Utility/JobSystem/JobSystem.inl"
 #include "Profiler/profiler.h"
 
 ScriptEngine* ScriptEngine::instance = nullptr;
 
+static void update_job(const void *_data)
+{
+	auto *data = static_cast<const JobSystem::ParallelFor<Script*, bool>*>(_data);
+
+	if (data->user_data)
+	{
+		for (Script **it = data->start; it != data->end; ++it)
+			(*it)->lateUpdate();
+	}
+	else
+	{
+		for (Script **it = data->start; it != data->end; ++it)
+			(*it)->update();
+	}
+}
+
 /// Methods (private)
-ScriptEngine::ScriptEngine()
+ScriptEngine::ScriptEngine():
+	deferring(false)
 { }
 
 ScriptEngine::~ScriptEngine()
@@ -16,7 +35,33 @@ ScriptEngine::~ScriptEngine()
 
 void ScriptEngine::clear()
 {
-	components.clear();
+	buckets.clear();
+	bucketIds[0].clear();
+	bucketIds[1].clear();
+}
+
+void ScriptEngine::updateParallel(bool _late)
+{
+	deferring = true;
+
+	// Launch every bucket before waiting
+	std::atomic<int> counter(0);
+	int jobs = 0;
+	for (Bucket& b: buckets)
+	{
+		if (!b.threadSafe || b.scripts.empty())
+			continue;
+
+		JobSystem::ParallelFor<Script*, bool> data{b.scripts.data(), (unsigned)b.scripts.size(), _late};
+		jobs += JobSystem::parallel_for(update_job, &data, &counter);
+	}
+	JobSystem::wait(&counter, jobs);
+
+	deferring = false;
+
+	// The scripts that follow see the changes made by the batch
+	if (jobs)
+		EntityCommandBuffer::get()->playback();
 }
 
 /// Methods (static)
@@ -42,32 +87,32 @@ ScriptEngine* ScriptEngine::get()
 /// Methods (public)
 void ScriptEngine::addComponent(Script* _script)
 {
+	_script->bucket = ~0u;
+	_script->index = started.size();
 	started.push_back(_script);
 }
 
 void ScriptEngine::removeComponent(const Script* _script)
 {
-	for (unsigned i(0) ; i < started.size() ; i++)
-	{
-		if (started[i] == _script)
-		{
-			started[i] = started.back();
-			started.pop_back();
+	std::vector<Script*>& scripts = (_script->bucket == ~0u) ? started : buckets[_script->bucket].scripts;
 
-			return;
-		}
-	}
+	Script* last = scripts.back();
+	last->index = _script->index;
+	scripts[_script->index] = last;
+	scripts.pop_back();
+}
 
-	for (unsigned i(0) ; i < components.size() ; i++)
-	{
-		if (components[i] == _script)
-		{
-			components[i] = components.back();
-			components.pop_back();
+void ScriptEngine::reserve(unsigned _count)
+{
+	reserveMore(started, _count);
+}
 
-			return;
-		}
-	}
+void ScriptEngine::defer(std::function<void()> _command)
+{
+	if (deferring)
+		EntityCommandBuffer::get()->defer(std::move(_command));
+	else
+		_command();
 }
 
 void ScriptEngine::start()
@@ -77,12 +122,26 @@ void ScriptEngine::start()
 	if (started.empty())
 		return;
 
-	components.reserve(components.size() + started.size());
-
 	for (unsigned i(0) ; i < started.size() ; i++)
 	{
-		started[i]->start();
-		components.push_back(started[i]);
+		Script* script = started[i];
+		script->start();
+
+		std::vector<unsigned>& ids = bucketIds[script->isThreadSafe()];
+		if (script->getType() >= ids.size())
+			ids.resize(script->getType() + 1, ~0u);
+
+		unsigned& id = ids[script->getType()];
+		if (id == ~0u)
+		{
+			id = buckets.size();
+			buckets.push_back({script->getType(), script->isThreadSafe(), {}});
+		}
+
+		std::vector<Script*>& scripts = buckets[id].scripts;
+		script->bucket = id;
+		script->index = scripts.size();
+		scripts.push_back(script);
 	}
 	started.clear();
 }
@@ -91,14 +150,30 @@ void ScriptEngine::update()
 {
 	MICROPROFILE_SCOPEI("SYSTEM_SCRIPTS", "update");
 
-	for (unsigned i(0) ; i < components.size() ; i++)
-		components[i]->update();
+	updateParallel(false);
+
+	for (Bucket& b: buckets)
+	{
+		if (b.threadSafe)
+			continue;
+
+		for (unsigned i(0) ; i < b.scripts.size() ; i++)
+			b.scripts[i]->update();
+	}
 }
 
-void ScriptEngine::lateUpdate() const
+void ScriptEngine::lateUpdate()
 {
 	MICROPROFILE_SCOPEI("SYSTEM_SCRIPTS", "lateUpdate");
 
-	for (unsigned i(0) ; i < components.size() ; i++)
-		components[i]->lateUpdate();
+	updateParallel(true);
+
+	for (Bucket& b: buckets)
+	{
+		if (b.threadSafe)
+			continue;
+
+		for (unsigned i(0) ; i < b.scripts.size() ; i++)
+			b.scripts[i]->lateUpdate();
+	}
 }
@@ -3,6 +3,8 @@
 
 #include "Utility/helpers.h"
 
+#include <functional>
+
 class Entity;
 class Script;
 
@@ -19,10 +21,16 @@ class ScriptEngine
 		/// Methods (public)
 			void addComponent(Script* _script);
 			void removeComponent(const Script* _script);
+			void reserve(unsigned _count);
 
 			void start();
 			void update();
-			void lateUpdate() const;
+			void lateUpdate();
+
+			// Structural changes (creating or destroying entities, adding components...) requested from
+			// thread safe scripts are recorded in the EntityCommandBuffer, which is played back after the batch.
+			// Outside of a batch, the command is executed immediately.
+			void defer(std::function<void()> _command);
 
 	private:
 		/// Methods (private)
@@ -31,12 +39,26 @@ class ScriptEngine
 
 			void clear();
 
+			void updateParallel(bool _late);
+
+			struct Bucket
+			{
+				unsigned type;
+				bool threadSafe;
+				std::vector<Script*> scripts;
+			};
+
 			static void create();
 			static void destroy();
 
 		/// Attributes (private)
 			std::vector<Script*> started;
-			std::vector<Script*> components;
+
+			// Scripts are grouped by type to call the same update function in a row
+			std::vector<Bucket> buckets;
+			std::vector<unsigned> bucketIds[2]; // indexed by threadSafe then component type
+
+			bool deferring;
 
 		/// Attributes (static)
 			static ScriptEngine* instance;
@@ -1,12 +1,20 @@
 #include "JobSystem.h"
 #include "Utility/Random.h"
+#include "Utility/Memory/LinearAllocator.h"
+#include "Profiler/profiler.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cassert>
 #include <cstring>
+#include <cstdio>
+#include <new>
 #include <thread>
 
 #ifdef __linux__
 #include <pthread.h>
+#include <dirent.h>
+#include <sched.h>
 #elif _WIN32
 #include <Windows.h>
 #else
@@ -17,164 +25,327 @@
 namespace JobSystem
 {
 // Job system
-bool work = true;
+std::atomic<bool> work(true);
+
+// operator new doesn't guarantee cache line alignment before C++17
+template <typename T>
+T *new_aligned(unsigned count, uint8_t *&memory)
+{
+	memory = new uint8_t[count * sizeof(T) + cacheline_size - 1];
+	uintptr_t aligned = ((uintptr_t)memory + cacheline_size - 1) & ~(uintptr_t)(cacheline_size - 1);
+
+	T *objects = reinterpret_cast<T*>(aligned);
+	for (unsigned i(0); i < count; i++)
+		new (objects + i) T();
+	return objects;
+}
+
+template <typename T>
+void delete_aligned(T *objects, unsigned count, uint8_t *memory)
+{
+	for (unsigned i(0); i < count; i++)
+		objects[i].~T();
+	delete[] memory;
+}
 
 // Workers
 unsigned num_worker;
 struct Worker *workers = nullptr;
+uint8_t *workers_memory = nullptr;
 thread_local unsigned this_worker;
 
+// Instrumentation
+std::atomic<bool> tracing(false);
+std::chrono::steady_clock::time_point trace_start;
+
+struct TraceEvent
+{
+	Work function;
+	int64_t begin, end; // in nanoseconds since trace start
+};
+
+inline int64_t elapsed_ns(std::chrono::steady_clock::time_point since)
+{
+	auto elapsed = std::chrono::steady_clock::now() - since;
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+// Counters are only written by their worker, relaxed atomics make them safe to read from other threads
+inline void increment(std::atomic<uint64_t> &counter, uint64_t value = 1)
+{
+	counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+// Large payloads
+LinearAllocator *arena = nullptr;
+thread_local LinearAllocator::Cache arena_cache;
+
 // Job pools
-const unsigned JOB_POOL_SIZE = 512;
-thread_local Job job_pool[JOB_POOL_SIZE];
-thread_local uint32_t job_pool_index = 0;
+// Jobs are recycled in a ring, a new block is inserted in the ring when the next job is still in flight
+struct JobPool
+{
+	static const unsigned BLOCK_SIZE = 512;
+
+	std::vector<Job*> blocks;
+	std::vector<uint8_t*> memory;
+	uint32_t index = 0;
+
+	Job *new_block()
+	{
+		memory.push_back(nullptr);
+		return new_aligned<Job>(BLOCK_SIZE, memory.back());
+	}
+
+	~JobPool()
+	{
+		for (size_t i(0); i < blocks.size(); i++)
+			delete_aligned(blocks[i], BLOCK_SIZE, memory[i]);
+	}
+};
+thread_local JobPool job_pool;
 
 Job* allocate_job()
 {
-	const uint32_t index = job_pool_index++;
-	return &job_pool[index & (JOB_POOL_SIZE-1u)];
+	JobPool &pool = job_pool;
+	if (pool.blocks.empty())
+		pool.blocks.push_back(pool.new_block());
+
+	uint32_t block = pool.index / JobPool::BLOCK_SIZE;
+	Job *job = pool.blocks[block] + pool.index % JobPool::BLOCK_SIZE;
+
+	if (job->state.load(std::memory_order_acquire) != Job::FREE)
+	{
+		pool.blocks.insert(pool.blocks.begin() + block, pool.new_block());
+		std::rotate(pool.memory.begin() + block, pool.memory.end() - 1, pool.memory.end());
+		pool.index = block * JobPool::BLOCK_SIZE;
+		job = pool.blocks[block];
+	}
+
+	pool.index = (pool.index + 1) % (pool.blocks.size() * JobPool::BLOCK_SIZE);
+	return job;
 }
 
 #ifdef __linux__
-#define COMPILER_BARRIER() asm volatile("" ::: "memory")
+#define THIS_THREAD pthread_self()
+#elif _WIN32
+#define THIS_THREAD GetCurrentThread()
+#endif
 
-#define ATOMIC_EXCHANGE  __sync_lock_test_and_set
-#define COMPARE_EXCHANGE __sync_bool_compare_and_swap
+// Chase-Lev deque, see 'Correct and Efficient Work-Stealing for Weak Memory Models' (Le et al. 2013)
+// The owner pushes and pops at the bottom, thieves steal from the top
+struct alignas(cacheline_size) Worker
+{
+	static const unsigned INITIAL_SIZE = 512u;
 
-#define THIS_THREAD pthread_self()
+	// Circular array, replaced by a bigger one when full
+	struct Array
+	{
+		Array(long _size): mask(_size - 1), jobs(new std::atomic<Job*>[_size]) {}
+		~Array() { delete[] jobs; }
 
-#elif _WIN32
-#define COMPILER_BARRIER() std::atomic_thread_fence(std::memory_order_release);
+		inline Job *get(long i) const { return jobs[i & mask].load(std::memory_order_relaxed); }
+		inline void put(long i, Job *job) { jobs[i & mask].store(job, std::memory_order_relaxed); }
 
-#define ATOMIC_EXCHANGE InterlockedExchange
-#define COMPARE_EXCHANGE(dest, cmp, val) (InterlockedCompareExchange(dest, val, cmp) == cmp)
+		long mask;
+		std::atomic<Job*> *jobs;
+	};
 
-#define THIS_THREAD GetCurrentThread()
+	Worker(): top(0), bottom(0), array(new Array(INITIAL_SIZE)) {}
+	~Worker()
+	{
+		delete array.load(std::memory_order_relaxed);
+		for (Array *a: retired)
+			delete a;
+	}
 
-#endif
+	// top is written by thieves, keep it away from the owner's data
+	alignas(cacheline_size) std::atomic<long> top;
+	alignas(cacheline_size) std::atomic<long> bottom;
+	std::atomic<Array*> array;
 
-struct Worker
-{
-	static const unsigned NUMBER_OF_JOBS = 512u;
-	static const unsigned MASK = NUMBER_OF_JOBS - 1u;
+	// Owner only
+	alignas(cacheline_size) std::thread thread;
+	std::vector<Array*> retired;
 
-	std::thread thread;
-	long bottom, top;
-	Job *jobs[NUMBER_OF_JOBS];
+	std::atomic<uint64_t> jobs{0}, steals{0}, failed_steals{0}, idle_ns{0};
+	std::vector<TraceEvent> trace;
+#if MICROPROFILE_ENABLED
+	MicroProfileToken tokens[4];
+#endif
 
 	Job *get_job()
 	{
 		if (Job *j = pop())
 			return j;
 
+		if (num_worker == 1)
+			return nullptr;
+
 		// Pick a random worker to steal from
 		unsigned steal_worker = Random::next<int>(0, num_worker - 1);
 		steal_worker += (steal_worker >= this_worker);
 
 		if (Job *j = workers[steal_worker].steal())
+		{
+			increment(steals);
 			return j;
+		}
 
+		increment(failed_steals);
 		return nullptr;
 	}
 
+	void execute(Job *job)
+	{
+		MICROPROFILE_SCOPEI("JOBSYSTEM", "job");
+		increment(jobs);
+
+		if (!tracing.load(std::memory_order_relaxed))
+			return job->run();
+
+		// record the event before waiting threads are signaled
+		TraceEvent event;
+		event.function = job->function;
+		event.begin = elapsed_ns(trace_start);
+		job->call();
+		event.end = elapsed_ns(trace_start);
+		trace.push_back(event);
+		job->finish();
+	}
+
+	void idle()
+	{
+		auto start = std::chrono::steady_clock::now();
+		std::this_thread::yield();
+		increment(idle_ns, elapsed_ns(start));
+	}
+
+	Array *grow(Array *a, long b, long t)
+	{
+		Array *bigger = new Array(2 * (a->mask + 1));
+		for (long i(t); i < b; i++)
+			bigger->put(i, a->get(i));
+
+		// thieves may still be reading from the old array, free it on destruction
+		retired.push_back(a);
+		array.store(bigger, std::memory_order_release);
+		return bigger;
+	}
+
 	void push(Job* job)
 	{
-		long b = bottom;
-		jobs[b & MASK] = job;
+		long b = bottom.load(std::memory_order_relaxed);
+		long t = top.load(std::memory_order_acquire);
+		Array *a = array.load(std::memory_order_relaxed);
+		if (b - t > a->mask)
+			a = grow(a, b, t);
 
-		// ensure the job is written before b+1 is published to other threads.
-		// on x86/64, a compiler barrier is enough.
-		COMPILER_BARRIER();
+		a->put(b, job);
 
-		bottom = b + 1;
+		// publish the job with the new bottom
+		bottom.store(b + 1, std::memory_order_release);
 	}
 
 	Job* pop()
 	{
-		long b = bottom - 1;
-		ATOMIC_EXCHANGE(&bottom, b);
+		long b = bottom.load(std::memory_order_relaxed) - 1;
+		Array *a = array.load(std::memory_order_relaxed);
+		bottom.store(b, std::memory_order_relaxed);
 
-		long t = top;
-		if (t <= b)
-		{
-			// non-empty queue
-			Job* job = jobs[b & MASK];
-			if (t != b)
-			{
-				// there's still more than one item left in the queue
-				return job;
-			}
-
-			// this is the last item in the queue
-			if (!COMPARE_EXCHANGE(&top, t, t+1))
-			{
-				// failed race against steal operation
-				job = nullptr;
-			}
+		// the write to bottom must be visible before reading top
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		long t = top.load(std::memory_order_relaxed);
 
-			bottom = t+1;
-			return job;
-		}
-		else
+		if (t > b)
 		{
 			// deque was already empty
-			bottom = t;
+			bottom.store(b + 1, std::memory_order_relaxed);
 			return nullptr;
 		}
+
+		Job* job = a->get(b);
+		if (t == b)
+		{
+			// this is the last item in the queue, race against steal operations
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				job = nullptr;
+
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+
+		return job;
 	}
 
 	Job* steal()
 	{
-		long t = top;
+		long t = top.load(std::memory_order_acquire);
 
-		// ensure that top is always read before bottom.
-		// loads will not be reordered with other loads on x86, so a compiler barrier is enough.
-		COMPILER_BARRIER();
+		// top must be read before bottom
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		long b = bottom.load(std::memory_order_acquire);
 
-		long b = bottom;
-		if (t < b)
-		{
-			// non-empty queue
-			Job* job = jobs[t & MASK];
+		if (t >= b)
+			return nullptr; // empty queue
 
-			// the interlocked function serves as a compiler barrier, and guarantees that the read happens before the CAS.
-			if (!COMPARE_EXCHANGE(&top, t, t+1))
-			{
-				// a concurrent steal or pop operation removed an element from the deque in the meantime.
-				return nullptr;
-			}
+		Array *a = array.load(std::memory_order_acquire);
+		Job* job = a->get(t);
 
-			return job;
-		}
-		else
-		{
-			// empty queue
+		// a concurrent steal or pop may have removed the element in the meantime
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
 			return nullptr;
-		}
+
+		return job;
 	}
 };
 
 void Job::run()
 {
-	function(data);
-	counter->fetch_add(1, std::memory_order_relaxed);
+	call();
+	finish();
+}
+
+void Job::call()
+{
+	if (state.load(std::memory_order_relaxed) == ARENA)
+		function(*reinterpret_cast<void**>(data));
+	else
+		function(data);
+}
+
+void Job::finish()
+{
+	// the job can be reused as soon as it is marked free
+	std::atomic<int> *c = counter;
+	state.store(FREE, std::memory_order_release);
+
+	// make the job side effects visible to threads waiting on the counter
+	if (c) c->fetch_add(1, std::memory_order_release);
 }
 
 void worker_main(const int i)
 {
 	this_worker = i; // TLS
+	Random::seedThread(i);
+
+	char name[32];
+	snprintf(name, sizeof(name), "Worker %d", i);
+	MicroProfileOnThreadCreate(name);
 
 	while (true)
 	{
 		if (Job* job = workers[i].get_job())
-			job->run();
+			workers[i].execute(job);
 
-		else if (!JobSystem::work) break;
-		else std::this_thread::yield();
+		else if (!work.load(std::memory_order_relaxed)) break;
+		else workers[i].idle();
 	}
+
+#if MICROPROFILE_ENABLED
+	MicroProfileOnThreadExit();
+#endif
 }
 
-void set_cpu_affinity(const std::thread::native_handle_type handle, const int cpu)
+void set_cpu_affinity(const std::thread::native_handle_type handle, const unsigned cpu)
 {
 	bool failed;
 
@@ -184,65 +355,346 @@ void set_cpu_affinity(const std::thread::native_handle_type handle, const int cp
 	CPU_SET(cpu, &cpuset);
 	failed = pthread_setaffinity_np(handle, sizeof(cpu_set_t), &cpuset);
 #elif _WIN32
-	failed = SetThreadAffinityMask(handle, (DWORD_PTR)(1 << cpu)) == 0;
+	failed = SetThreadAffinityMask(handle, (DWORD_PTR)1 << cpu) == 0;
 #endif
 
 #ifdef DEBUG
-	if (failed) printf("[WARNING] Failed to set cpu affinity for cpu %d\n", cpu);
+	if (failed) printf("[WARNING] Failed to set cpu affinity for cpu %u\n", cpu);
 #endif
 }
 
-void init()
+#ifdef __linux__
+int read_cpu_value(const char *format, unsigned cpu, unsigned index = 0)
+{
+	char path[128];
+	snprintf(path, sizeof(path), format, cpu, index);
+
+	int value = -1;
+	if (FILE *file = fopen(path, "r"))
+	{
+		if (fscanf(file, "%d", &value) != 1)
+			value = -1;
+		fclose(file);
+	}
+	return value;
+}
+
+struct CpuInfo
+{
+	unsigned cpu;
+	int node, package, cache, core;
+
+	CpuInfo(unsigned _cpu): cpu(_cpu)
+	{
+		package = read_cpu_value("/sys/devices/system/cpu/cpu%u/topology/physical_package_id", cpu);
+		core = read_cpu_value("/sys/devices/system/cpu/cpu%u/topology/core_id", cpu);
+
+		// Last level cache is the one with the highest level
+		cache = -1;
+		for (unsigned i(0), level(0); ; i++)
+		{
+			int l = read_cpu_value("/sys/devices/system/cpu/cpu%u/cache/index%u/level", cpu, i);
+			if (l < 0) break;
+			if ((unsigned)l < level) continue;
+
+			level = l;
+			cache = read_cpu_value("/sys/devices/system/cpu/cpu%u/cache/index%u/id", cpu, i);
+		}
+
+		// The numa node is exposed as a 'nodeX' link
+		node = 0;
+		char path[64];
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u", cpu);
+		if (DIR *dir = opendir(path))
+		{
+			while (dirent *entry = readdir(dir))
+				if (sscanf(entry->d_name, "node%d", &node) == 1)
+					break;
+			closedir(dir);
+		}
+	}
+
+	bool operator<(const CpuInfo &other) const
+	{
+		if (node != other.node) return node < other.node;
+		if (package != other.package) return package < other.package;
+		if (cache != other.cache) return cache < other.cache;
+		if (core != other.core) return core < other.core;
+		return cpu < other.cpu;
+	}
+};
+
+// Number of cpus allowed by the cgroup bandwidth limit (0 if unlimited)
+unsigned cpu_quota()
+{
+	long quota = -1, period = 0;
+	if (FILE *file = fopen("/sys/fs/cgroup/cpu.max", "r")) // cgroup v2
+	{
+		if (fscanf(file, "%ld %ld", &quota, &period) != 2)
+			quota = -1;
+		fclose(file);
+	}
+	else
+	{
+		if (FILE *file = fopen("/sys/fs/cgroup/cpu/cpu.cfs_quota_us", "r")) // cgroup v1
+		{
+			if (fscanf(file, "%ld", &quota) != 1)
+				quota = -1;
+			fclose(file);
+		}
+		if (FILE *file = fopen("/sys/fs/cgroup/cpu/cpu.cfs_period_us", "r"))
+		{
+			if (fscanf(file, "%ld", &period) != 1)
+				period = 0;
+			fclose(file);
+		}
+	}
+
+	if (quota <= 0 || period <= 0)
+		return 0;
+	return (unsigned)((quota + period - 1) / period);
+}
+#endif
+
+// Cpus the process is allowed to run on, in the order workers should be placed
+std::vector<unsigned> usable_cpus()
+{
+	std::vector<unsigned> cpus;
+
+#ifdef __linux__
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	if (sched_getaffinity(0, sizeof(cpu_set_t), &cpuset) == 0)
+	{
+		std::vector<CpuInfo> infos;
+		for (unsigned cpu(0); cpu < CPU_SETSIZE; cpu++)
+			if (CPU_ISSET(cpu, &cpuset))
+				infos.emplace_back(cpu);
+
+		// Keep workers on the same numa node and cache, one per physical core before using smt siblings
+		std::sort(infos.begin(), infos.end());
+		std::vector<unsigned> siblings;
+		for (size_t i(0); i < infos.size(); i++)
+		{
+			bool sibling = i && infos[i].core == infos[i-1].core && infos[i].package == infos[i-1].package;
+			if (sibling && infos[i].core != -1) siblings.push_back(infos[i].cpu);
+			else cpus.push_back(infos[i].cpu);
+		}
+		cpus.insert(cpus.end(), siblings.begin(), siblings.end());
+	}
+#elif _WIN32
+	DWORD_PTR process_mask, system_mask;
+	if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+	{
+		for (unsigned cpu(0); cpu < sizeof(DWORD_PTR) * 8; cpu++)
+			if (process_mask & ((DWORD_PTR)1 << cpu))
+				cpus.push_back(cpu);
+	}
+#endif
+
+	if (cpus.empty())
+	{
+		for (unsigned cpu(0); cpu < std::thread::hardware_concurrency(); cpu++)
+			cpus.push_back(cpu);
+	}
+
+	return cpus;
+}
+
+void init(const Config &config)
 {
 	if (workers)
 		return;
 
-	num_worker = std::thread::hardware_concurrency();
-	workers = new Worker[num_worker];
+	std::vector<unsigned> cpus = config.cpus.empty() ? usable_cpus() : config.cpus;
 
-	work = true;
+	num_worker = config.worker_count;
+	if (num_worker == 0)
+	{
+		num_worker = (unsigned)cpus.size();
+#ifdef __linux__
+		unsigned quota = cpu_quota();
+		if (quota && quota < num_worker)
+			num_worker = quota;
+#endif
+	}
+	if (num_worker == 0)
+		num_worker = 1;
+
+	// Pinning is opt-in, several engines may share the host
+	// Don't pin several workers to the same cpu
+	bool pin = config.affinity || !config.cpus.empty();
+	bool affinity = pin && num_worker <= cpus.size();
+#ifdef DEBUG
+	if (pin && !affinity)
+		printf("[WARNING] More workers than cpus (%u > %u), affinity is disabled\n", num_worker, (unsigned)cpus.size());
+#endif
+
+	workers = new_aligned<Worker>(num_worker, workers_memory);
+	arena = new LinearAllocator(config.arena_size);
+
+	work.store(true, std::memory_order_relaxed);
+
+#if MICROPROFILE_ENABLED
 	for (unsigned i(0); i < num_worker; i++)
-		workers[i].bottom = workers[i].top = 0;
+	{
+		const char *names[] = {"jobs", "steals", "failed steals", "idle us"};
+		for (unsigned c(0); c < 4; c++)
+		{
+			char name[64];
+			snprintf(name, sizeof(name), "jobsystem/worker %u/%s", i, names[c]);
+			workers[i].tokens[c] = MicroProfileGetCounterToken(name);
+		}
+	}
+#endif
 
 	// Launch threads
-	set_cpu_affinity(THIS_THREAD, 0); // main thread
+	this_worker = 0;
+	Random::seedThread(0);
+	if (affinity) set_cpu_affinity(THIS_THREAD, cpus[0]); // main thread
 	for (unsigned i(1); i < num_worker; i++)
 	{
 		workers[i].thread = std::thread(worker_main, i);
-		set_cpu_affinity(workers[i].thread.native_handle(), i);
+		if (affinity) set_cpu_affinity(workers[i].thread.native_handle(), cpus[i]);
 	}
 }
 
 void destroy()
 {
-	work = false;
+	work.store(false, std::memory_order_relaxed);
 
 	for (unsigned i(1); i < num_worker; i++)
 		workers[i].thread.join();
-	delete[] workers;
+	delete_aligned(workers, num_worker, workers_memory);
+	workers = nullptr;
+
+	delete arena;
+	arena = nullptr;
 }
 
 void run(Work func, const void *data, unsigned n, std::atomic<int> *counter)
 {
-	assert(n <= sizeof(Job::data));
+	void *payload = nullptr;
+	if (n > sizeof(Job::data))
+	{
+		// Store big payloads in the arena, the job only holds a pointer
+		payload = arena->alloc(arena_cache, n, cacheline_size);
+		if (payload == nullptr)
+		{
+			func(data);
+			if (counter) counter->fetch_add(1, std::memory_order_release);
+			return;
+		}
+		memcpy(payload, data, n);
+	}
 
 	Job* job = allocate_job();
 	job->function = func;
 	job->counter = counter;
-	memcpy(job->data, data, n);
+	if (payload)
+	{
+		job->state.store(Job::ARENA, std::memory_order_relaxed);
+		memcpy(job->data, &payload, sizeof(payload));
+	}
+	else
+	{
+		job->state.store(Job::INLINE, std::memory_order_relaxed);
+		if (n) memcpy(job->data, data, n); // data may be null when there is no payload
+	}
 
 	workers[this_worker].push(job);
 }
 
+void reset_arena()
+{
+	arena->clear();
+}
+
 void wait(const std::atomic<int> *counter, const int value)
 {
-	while (counter->load(std::memory_order_relaxed) != value)
+	while (counter->load(std::memory_order_acquire) != value)
+		yield();
+}
+
+void yield()
+{
+	if (Job* job = workers[this_worker].get_job())
+		workers[this_worker].execute(job);
+
+	else workers[this_worker].idle();
+}
+
+Stats stats(unsigned worker)
+{
+	const Worker &w = workers[worker];
+
+	Stats s;
+	s.jobs = w.jobs.load(std::memory_order_relaxed);
+	s.steals = w.steals.load(std::memory_order_relaxed);
+	s.failed_steals = w.failed_steals.load(std::memory_order_relaxed);
+	s.idle_ns = w.idle_ns.load(std::memory_order_relaxed);
+	return s;
+}
+
+void reset_stats()
+{
+	for (unsigned i(0); i < num_worker; i++)
+	{
+		workers[i].jobs.store(0, std::memory_order_relaxed);
+		workers[i].steals.store(0, std::memory_order_relaxed);
+		workers[i].failed_steals.store(0, std::memory_order_relaxed);
+		workers[i].idle_ns.store(0, std::memory_order_relaxed);
+	}
+}
+
+void publish_stats()
+{
+#if MICROPROFILE_ENABLED
+	for (unsigned i(0); i < num_worker; i++)
+	{
+		Stats s = stats(i);
+		MicroProfileCounterSet(workers[i].tokens[0], s.jobs);
+		MicroProfileCounterSet(workers[i].tokens[1], s.steals);
+		MicroProfileCounterSet(workers[i].tokens[2], s.failed_steals);
+		MicroProfileCounterSet(workers[i].tokens[3], s.idle_ns / 1000);
+	}
+#endif
+}
+
+void start_trace()
+{
+	for (unsigned i(0); i < num_worker; i++)
+		workers[i].trace.clear();
+
+	trace_start = std::chrono::steady_clock::now();
+	tracing.store(true, std::memory_order_relaxed);
+}
+
+bool stop_trace(const char *path)
+{
+	tracing.store(false, std::memory_order_relaxed);
+
+	FILE *file = fopen(path, "w");
+	if (file == nullptr)
+		return false;
+
+	// Chrome trace event format, timestamps are in microseconds
+	const char *separator = "";
+	fprintf(file, "{\"traceEvents\":[\n");
+	for (unsigned i(0); i < num_worker; i++)
 	{
-		if (Job* job = workers[this_worker].get_job())
-			job->run();
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Worker %u\"}}", separator, i, i);
+		separator = ",\n";
 
-		else std::this_thread::yield();
+		for (const TraceEvent &event: workers[i].trace)
+		{
+			fprintf(file, ",\n{\"name\":\"%p\",\"cat\":\"job\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				(void*)event.function, i, event.begin / 1000.0, (event.end - event.begin) / 1000.0);
+		}
 	}
+	fprintf(file, "\n]}\n");
+
+	return fclose(file) == 0;
 }
 
 unsigned worker_count()
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
 #include <atomic>
+#include <functional>
+#include <vector>
 
 namespace JobSystem
 {
@@ -14,10 +17,18 @@ struct alignas(cacheline_size) Job
 	void run();
 
 private:
+	enum State : uint32_t { FREE, INLINE, ARENA };
+
+	void call();
+	void finish(); // release the job and signal the counter
+
 	Work function;
 	std::atomic<int> *counter;
-	uint8_t data[cacheline_size - sizeof(Work) - sizeof(std::atomic<int>*)];
+	std::atomic<uint32_t> state{FREE};
+	uint8_t data[cacheline_size - sizeof(Work) - sizeof(std::atomic<int>*) - sizeof(std::atomic<uint32_t>)];
 
+	friend Job* allocate_job();
+	friend struct Worker;
 	friend void run(Work func, const void *data, unsigned n, std::atomic<int> *counter);
 };
 static_assert(sizeof(Job) == cacheline_size, "Job size is invalid");
@@ -37,15 +48,49 @@ struct ParallelFor
 	D user_data;
 };
 
-void init();
+struct Config
+{
+	unsigned worker_count = 0;	// 0 means one worker per usable cpu
+	bool affinity = false;	// pin worker i to the i-th usable cpu, ordered by numa node, cache and core
+	std::vector<unsigned> cpus;	// if set, worker i is pinned to cpus[i] instead
+	size_t arena_size = 1 << 20;	// storage for payloads that don't fit in a job
+};
+
+void init(const Config &config = Config());
 void destroy();
 
+// Payloads bigger than a job are copied to a per-frame arena
+// If the arena is full, the job is executed immediately
 void run(Work func, const void *data, unsigned n, std::atomic<int> *counter = nullptr);
 void wait(const std::atomic<int> *counter, const int value);
 
+// Execute one pending job or idle, for custom wait loops
+void yield();
+
+// Release arena memory, no job must be in flight
+void reset_arena();
+
 unsigned worker_count();
 unsigned worker_id();
 
+// Instrumentation
+struct Stats
+{
+	uint64_t jobs;		// jobs executed by the worker
+	uint64_t steals;	// jobs taken from another worker
+	uint64_t failed_steals;	// steal attempts that found nothing
+	uint64_t idle_ns;	// time spent without work
+};
+
+Stats stats(unsigned worker);
+void reset_stats();
+void publish_stats(); // send counters to the profiler
+
+// Record job execution per worker, saved in the chrome trace event format (chrome://tracing)
+// Must be stopped while no job is in flight
+void start_trace();
+bool stop_trace(const char *path);
+
 
 inline unsigned div_ceil(unsigned a, unsigned b)
 {
@@ -57,4 +102,18 @@ inline void run(Work func, const D *data, std::atomic<int> *counter = nullptr);
 
 template <typename T, typename D>
 unsigned parallel_for(Work func, ParallelFor<T, D> *data, std::atomic<int> *counter = nullptr);
+
+// The following primitives block until completion.
+// Op and Compare are only referenced by the jobs, so they can capture anything.
+// T must be default constructible.
+template <typename T, typename Op>
+T parallel_reduce(const T *data, unsigned count, T identity, Op op);
+
+// Exclusive scan, in and out may alias. Returns the reduction of the whole range.
+template <typename T, typename Op>
+T parallel_scan(const T *in, T *out, unsigned count, T identity, Op op);
+
+// Merge sort, buffer must hold count elements (allocated internally if null).
+template <typename T, typename Compare = std::less<T>>
+void parallel_sort(T *data, unsigned count, T *buffer = nullptr, Compare comp = Compare());
 }
\ No newline at end of file
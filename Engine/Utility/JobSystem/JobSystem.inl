@@ -1,5 +1,7 @@
 #include "Utility/JobSystem/JobSystem.h"
 
+#include <algorithm>
+
 namespace JobSystem
 {
 template <typename D>
@@ -32,4 +34,205 @@ unsigned parallel_for(Work func, ParallelFor<T, D> *data, std::atomic<int> *coun
 
 	return i;
 }
-}
\ No newline at end of file
+
+
+/// Parallel primitives
+const unsigned MAX_CHUNKS = 64;
+
+// Split [0, count[ in at most one chunk per worker, each holding at least min_load elements
+inline unsigned split(unsigned count, unsigned min_load, unsigned *bounds)
+{
+	unsigned chunks = std::min(worker_count(), div_ceil(count, min_load));
+	chunks = std::max(std::min(chunks, MAX_CHUNKS), 1u);
+
+	for (unsigned i(0); i <= chunks; i++)
+		bounds[i] = (unsigned)((uint64_t)count * i / chunks);
+
+	return chunks;
+}
+
+template <typename T, typename Op>
+struct ReduceData
+{
+	const T *start, *end;
+	const Op *op;
+	T *result;
+};
+
+template <typename T, typename Op>
+void reduce_job(const void *_data)
+{
+	auto *data = static_cast<const ReduceData<T, Op>*>(_data);
+
+	T acc = *data->start;
+	for (const T *it = data->start + 1; it != data->end; ++it)
+		acc = (*data->op)(acc, *it);
+	*data->result = acc;
+}
+
+template <typename T, typename Op>
+T parallel_reduce(const T *data, unsigned count, T identity, Op op)
+{
+	if (count == 0)
+		return identity;
+
+	unsigned bounds[MAX_CHUNKS + 1];
+	unsigned chunks = split(count, 1024u, bounds);
+
+	T partial[MAX_CHUNKS];
+	std::atomic<int> counter(0);
+	for (unsigned i(0); i < chunks; i++)
+	{
+		ReduceData<T, Op> job{data + bounds[i], data + bounds[i+1], &op, partial + i};
+		run(reduce_job<T, Op>, &job, &counter);
+	}
+	wait(&counter, chunks);
+
+	T acc = identity;
+	for (unsigned i(0); i < chunks; i++)
+		acc = op(acc, partial[i]);
+	return acc;
+}
+
+template <typename T, typename Op>
+struct ScanData
+{
+	const T *start, *end;
+	T *out;
+	const Op *op;
+	const T *offset;
+};
+
+template <typename T, typename Op>
+void scan_job(const void *_data)
+{
+	auto *data = static_cast<const ScanData<T, Op>*>(_data);
+
+	T acc = *data->offset;
+	T *out = data->out;
+	for (const T *it = data->start; it != data->end; ++it)
+	{
+		T value = *it;
+		*(out++) = acc;
+		acc = (*data->op)(acc, value);
+	}
+}
+
+template <typename T, typename Op>
+T parallel_scan(const T *in, T *out, unsigned count, T identity, Op op)
+{
+	if (count == 0)
+		return identity;
+
+	unsigned bounds[MAX_CHUNKS + 1];
+	unsigned chunks = split(count, 1024u, bounds);
+
+	// Reduce each chunk
+	T offsets[MAX_CHUNKS];
+	std::atomic<int> counter(0);
+	for (unsigned i(0); i < chunks; i++)
+	{
+		ReduceData<T, Op> job{in + bounds[i], in + bounds[i+1], &op, offsets + i};
+		run(reduce_job<T, Op>, &job, &counter);
+	}
+	wait(&counter, chunks);
+
+	// Scan chunk sums
+	T acc = identity;
+	for (unsigned i(0); i < chunks; i++)
+	{
+		T sum = offsets[i];
+		offsets[i] = acc;
+		acc = op(acc, sum);
+	}
+
+	// Scan each chunk starting from its offset
+	counter.store(0, std::memory_order_relaxed);
+	for (unsigned i(0); i < chunks; i++)
+	{
+		ScanData<T, Op> job{in + bounds[i], in + bounds[i+1], out + bounds[i], &op, offsets + i};
+		run(scan_job<T, Op>, &job, &counter);
+	}
+	wait(&counter, chunks);
+
+	return acc;
+}
+
+template <typename T, typename Compare>
+struct SortData
+{
+	T *start, *end;
+	const Compare *comp;
+};
+
+template <typename T, typename Compare>
+void sort_job(const void *_data)
+{
+	auto *data = static_cast<const SortData<T, Compare>*>(_data);
+	std::sort(data->start, data->end, *data->comp);
+}
+
+template <typename T, typename Compare>
+struct MergeData
+{
+	const T *start, *mid, *end;
+	T *out;
+	const Compare *comp;
+};
+
+template <typename T, typename Compare>
+void merge_job(const void *_data)
+{
+	auto *data = static_cast<const MergeData<T, Compare>*>(_data);
+	std::merge(data->start, data->mid, data->mid, data->end, data->out, *data->comp);
+}
+
+template <typename T, typename Compare>
+void parallel_sort(T *data, unsigned count, T *buffer, Compare comp)
+{
+	unsigned bounds[MAX_CHUNKS + 1];
+	unsigned chunks = split(count, 4096u, bounds);
+
+	if (chunks == 1)
+		return std::sort(data, data + count, comp);
+
+	// Sort each chunk
+	std::atomic<int> counter(0);
+	for (unsigned i(0); i < chunks; i++)
+	{
+		SortData<T, Compare> job{data + bounds[i], data + bounds[i+1], &comp};
+		run(sort_job<T, Compare>, &job, &counter);
+	}
+
+	T *allocated = nullptr;
+	if (buffer == nullptr)
+		buffer = allocated = new T[count];
+
+	wait(&counter, chunks);
+
+	// Merge sorted runs pairwise, ping-ponging between data and buffer
+	T *src = data, *dst = buffer;
+	for (unsigned width(1); width < chunks; width *= 2)
+	{
+		int jobs = 0;
+		counter.store(0, std::memory_order_relaxed);
+		for (unsigned i(0); i < chunks; i += 2 * width)
+		{
+			unsigned mid = bounds[std::min(i + width, chunks)];
+			unsigned end = bounds[std::min(i + 2 * width, chunks)];
+
+			MergeData<T, Compare> job{src + bounds[i], src + mid, src + end, dst + bounds[i], &comp};
+			run(merge_job<T, Compare>, &job, &counter);
+			jobs++;
+		}
+		wait(&counter, jobs);
+
+		std::swap(src, dst);
+	}
+
+	if (src != data)
+		std::copy(src, src + count, data);
+
+	delete[] allocated;
+}
+}
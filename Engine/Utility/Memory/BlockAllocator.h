@@ -2,15 +2,21 @@
 
 #include "StackAllocator.h"
 
+#include <cstddef>
+
+// Elements are packed in blocks of block_size, which relies on new aligning the blocks for T
+// They fill every block exactly, so no tail is left for the stack to reuse and count() holds
 template <size_t block_size, typename T>
 struct BlockAllocator : public StackAllocator<block_size * sizeof(T)>
 {
+	static_assert(alignof(T) <= alignof(std::max_align_t), "Blocks are not aligned for T");
+
 	static const size_t block_bytes = block_size * sizeof(T);
 	using Super = StackAllocator<block_bytes>;
 
 	inline T *alloc()
 	{
-		void *data = Super::alloc(sizeof(T));
+		void *data = Super::alloc(sizeof(T), alignof(T));
 		return reinterpret_cast<T*>(data);
 	}
 
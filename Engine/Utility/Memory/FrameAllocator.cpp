@@ -0,0 +1,77 @@
+#include "Utility/Memory/FrameAllocator.h"
+#include "Utility/JobSystem/JobSystem.h"
+
+FrameAllocator* FrameAllocator::instance = nullptr;
+
+FrameAllocator::FrameAllocator(size_t _size):
+	frame(0), overflows(0)
+{
+	for (auto& frameAllocators: allocators)
+	{
+		for (unsigned i(0); i < JobSystem::worker_count(); i++)
+			frameAllocators.push_back(new LinearAllocator(_size, true));
+	}
+}
+
+FrameAllocator::~FrameAllocator()
+{
+	for (unsigned i(0); i < 2; i++)
+	{
+		for (LinearAllocator *allocator: allocators[i])
+			delete allocator;
+	}
+}
+
+/// Methods (static)
+void FrameAllocator::create(size_t _size)
+{
+	if (instance != nullptr)
+		return;
+
+	instance = new FrameAllocator(_size);
+}
+
+void FrameAllocator::destroy()
+{
+	delete instance;
+	instance = nullptr;
+}
+
+/// Methods (public)
+void *FrameAllocator::alloc(size_t bytes, uint32_t alignment)
+{
+	return allocators[frame][JobSystem::worker_id()]->alloc(bytes, alignment);
+}
+
+void FrameAllocator::flip()
+{
+	frame ^= 1;
+
+	for (LinearAllocator *allocator: allocators[frame])
+	{
+		overflows += allocator->getBlockCount() - 1;
+		allocator->clear();
+	}
+}
+
+/// Getters
+size_t FrameAllocator::getUsed() const
+{
+	size_t used = 0;
+	for (LinearAllocator *allocator: allocators[frame])
+		used += allocator->getSize();
+
+	return used;
+}
+
+size_t FrameAllocator::getOverflow() const
+{
+	size_t count = overflows;
+	for (auto& frameAllocators: allocators)
+	{
+		for (LinearAllocator *allocator: frameAllocators)
+			count += allocator->getBlockCount() - 1;
+	}
+
+	return count;
+}
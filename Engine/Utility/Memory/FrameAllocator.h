@@ -0,0 +1,78 @@
+#pragma once
+
+#include "LinearAllocator.h"
+
+#include <vector>
+
+// Transient memory that stays valid until the end of the next frame
+// Every worker allocates from its own LinearAllocator. There are two sets of them, the engine flips
+// at the beginning of each frame and releases the memory of the frame before the previous one.
+// A worker that runs out of memory chains a new block, which is merged at the next release.
+class FrameAllocator
+{
+	friend class Engine;
+
+public:
+	FrameAllocator(size_t _size); // per worker and per frame
+	~FrameAllocator();
+
+	/// Methods (static)
+	static FrameAllocator* get()	{ return instance; }
+
+	/// Methods (public)
+	void *alloc(size_t bytes, uint32_t alignment = alignof(std::max_align_t));
+
+	template <typename T>
+	T *alloc(size_t count)
+	{ return static_cast<T*>(alloc(count * sizeof(T), alignof(T))); }
+
+	void flip(); // no allocation from the frame before the previous one must still be used
+
+	/// Getters
+	size_t getUsed() const; // by the current frame
+	size_t getOverflow() const; // blocks chained since creation
+
+private:
+	/// Methods (static)
+	static void create(size_t _size);
+	static void destroy();
+
+	/// Attributes
+	std::vector<LinearAllocator*> allocators[2]; // indexed by frame, then worker
+	unsigned frame;
+	size_t overflows; // blocks chained by released frames
+
+	/// Attributes (static)
+	static FrameAllocator* instance;
+};
+
+// STL allocator for transient containers, uses the frame allocator of the engine by default
+template <typename T>
+struct FrameSTLAllocator
+{
+	typedef T value_type;
+
+	FrameSTLAllocator(FrameAllocator *_allocator = FrameAllocator::get()):
+		allocator(_allocator)
+	{ }
+
+	template <typename U>
+	FrameSTLAllocator(const FrameSTLAllocator<U> &_other):
+		allocator(_other.allocator)
+	{ }
+
+	T *allocate(size_t n)
+	{ return allocator->alloc<T>(n); }
+
+	void deallocate(T*, size_t) {}
+
+	template <typename U>
+	bool operator==(const FrameSTLAllocator<U> &_other) const	{ return allocator == _other.allocator; }
+	template <typename U>
+	bool operator!=(const FrameSTLAllocator<U> &_other) const	{ return allocator != _other.allocator; }
+
+	FrameAllocator *allocator;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameSTLAllocator<T>>;
@@ -1,20 +1,140 @@
 #include "Utility/Memory/LinearAllocator.h"
 #include "Utility/Memory/Memory.h"
 
-#include <iostream>
+#include <algorithm>
 
-void* LinearAllocator::alloc(size_t bytes, uint32_t alignment)
+std::atomic<uint64_t> LinearAllocator::epochs(1);
+
+LinearAllocator::LinearAllocator(size_t _size, bool _growable, size_t _reserve):
+	head(new Block(_size, nullptr)), epoch(epochs.fetch_add(1)),
+	reserve(_reserve), growable(_growable)
+{ }
+
+LinearAllocator::~LinearAllocator()
 {
-	bytes = align(bytes, alignment);
+	Block *block = head.load(std::memory_order_relaxed);
+	while (block)
+	{
+		Block *next = block->next;
+		delete block;
+		block = next;
+	}
+}
 
-	uint32_t index = current.fetch_add(bytes, std::memory_order_relaxed);
-	uint8_t *ptr = pool + index;
+void LinearAllocator::clear()
+{
+	Block *block = head.load(std::memory_order_relaxed);
+	if (block->next)
+	{
+		size_t capacity = getCapacity();
+		while (block)
+		{
+			Block *next = block->next;
+			delete block;
+			block = next;
+		}
+		head.store(new Block(capacity, nullptr), std::memory_order_release);
+	}
+	else
+		block->current.store(0, std::memory_order_relaxed);
 
-	if (index > size)
+	epoch.store(epochs.fetch_add(1), std::memory_order_release);
+}
+
+void* LinearAllocator::alloc(size_t bytes, size_t alignment)
+{
+	Block *block = head.load(std::memory_order_acquire);
+	while (block)
 	{
-		std::cout << "out of memory " << index << " " << size << std::endl;
-		return nullptr;
+		uintptr_t base = reinterpret_cast<uintptr_t>(block->data);
+		size_t index = block->current.load(std::memory_order_relaxed);
+		while (true)
+		{
+			// Check the range fits before taking it
+			size_t start = index + (alignment - (base + index) % alignment) % alignment;
+			if (start > block->size || bytes > block->size - start)
+				break;
+
+			if (block->current.compare_exchange_weak(index, start + bytes, std::memory_order_relaxed))
+				return block->data + start;
+		}
+
+		block = grow(block, bytes, alignment);
+	}
+
+	return nullptr;
+}
+
+void* LinearAllocator::alloc(Cache &cache, size_t bytes, size_t alignment)
+{
+	if (cache.epoch != epoch.load(std::memory_order_acquire))
+	{
+		cache.cursor = cache.end = nullptr;
+		cache.epoch = epoch.load(std::memory_order_relaxed);
 	}
 
-	return ptr;
+	if (cache.cursor)
+	{
+		uint8_t *data = align(cache.cursor, alignment);
+		if (data <= cache.end && bytes <= size_t(cache.end - data))
+		{
+			cache.cursor = data + bytes;
+			return data;
+		}
+	}
+
+	// Big allocations would waste most of a sub-block
+	if (bytes + alignment > reserve / 4)
+		return alloc(bytes, alignment);
+
+	// Sub-blocks are aligned on cache lines, threads don't write to the same line
+	uint8_t *sub = static_cast<uint8_t*>(alloc(reserve, 64));
+	if (sub == nullptr)
+		return alloc(bytes, alignment);
+
+	uint8_t *data = align(sub, alignment);
+	cache.cursor = data + bytes;
+	cache.end = sub + reserve;
+	return data;
+}
+
+size_t LinearAllocator::getSize() const
+{
+	size_t size = 0;
+	for (Block *block = head.load(std::memory_order_acquire); block; block = block->next)
+		size += block->current.load(std::memory_order_relaxed);
+	return size;
+}
+
+size_t LinearAllocator::getCapacity() const
+{
+	size_t capacity = 0;
+	for (Block *block = head.load(std::memory_order_acquire); block; block = block->next)
+		capacity += block->size;
+	return capacity;
+}
+
+unsigned LinearAllocator::getBlockCount() const
+{
+	unsigned count = 0;
+	for (Block *block = head.load(std::memory_order_acquire); block; block = block->next)
+		count++;
+	return count;
+}
+
+LinearAllocator::Block *LinearAllocator::grow(Block *full, size_t bytes, size_t alignment)
+{
+	if (!growable)
+		return nullptr;
+
+	std::lock_guard<std::mutex> guard(lock);
+
+	// Another thread already chained a block
+	Block *block = head.load(std::memory_order_relaxed);
+	if (block != full)
+		return block;
+
+	block = new Block(std::max(2 * full->size, bytes + alignment), full);
+	head.store(block, std::memory_order_release);
+	return block;
 }
@@ -3,33 +3,57 @@
 #include <cstdint>
 #include <cstddef>
 #include <atomic>
-#include <cassert>
+#include <mutex>
 
+// Thread safe bump allocator
+// When the block is full, a new one is chained if the allocator can grow, otherwise alloc returns nullptr.
+// clear() merges the chained blocks into one, so a steady workload stops chaining after the first frames.
 class LinearAllocator
 {
 public:
-	LinearAllocator(size_t _size):
-		size(_size), pool(new uint8_t[size]), current(0)
+	// Sub-block reserved by a thread, allocations from it don't touch the shared offset
+	struct Cache
 	{
-		assert(current.is_lock_free());
-		assert(size % sizeof(uint32_t) == 0);
-	}
-	~LinearAllocator() { delete[] pool; }
+		uint8_t *cursor = nullptr, *end = nullptr;
+		uint64_t epoch = 0;
+	};
 
-	inline void clear()
-	{
-		current.store(0, std::memory_order_release);
-	}
+	LinearAllocator(size_t _size, bool _growable = false, size_t _reserve = 4096);
+	~LinearAllocator();
+
+	void clear(); // no allocation must be in flight
 
-	inline uint8_t *getStart() const { return pool; }
-	inline size_t getSize() const { return current; }
+	void *alloc(size_t bytes, size_t alignment = 1);
+	void *alloc(Cache &cache, size_t bytes, size_t alignment = 1);
 
-	void *alloc(size_t bytes, uint32_t alignment = 1);
+	size_t getSize() const; // bytes used, including the sub-blocks reserved by caches
+	size_t getCapacity() const;
+	unsigned getBlockCount() const;
 
 private:
-	size_t size;
-	uint8_t *pool;
-	std::atomic<size_t> current;
+	struct Block
+	{
+		Block(size_t _size, Block *_next):
+			data(new uint8_t[_size]), size(_size), current(0), next(_next)
+		{ }
+		~Block() { delete[] data; }
+
+		uint8_t *data;
+		size_t size;
+		std::atomic<size_t> current;
+		Block *next;
+	};
+
+	Block *grow(Block *full, size_t bytes, size_t alignment);
+
+	std::atomic<Block*> head;
+	std::atomic<uint64_t> epoch; // caches from before the last clear are discarded
+	std::mutex lock;
+
+	size_t reserve;
+	bool growable;
+
+	static std::atomic<uint64_t> epochs;
 
 	LinearAllocator(const LinearAllocator&) = delete;
 	void operator=(const LinearAllocator&) = delete;
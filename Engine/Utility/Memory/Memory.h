@@ -1,10 +1,19 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 inline uint32_t align(uint32_t val, uint32_t alignment)
 {
 	return ((val + alignment - 1) / alignment ) * alignment;
 }
 
+inline uint8_t *align(uint8_t *ptr, size_t alignment)
+{
+	uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+	return ptr + (alignment - address % alignment) % alignment;
+}
+
 inline uint32_t next_power_of_two(uint32_t x)
 {
 	x--;
@@ -14,4 +23,4 @@ inline uint32_t next_power_of_two(uint32_t x)
 	x |= x >> 8;
 	x |= x >> 16;
 	return ++x;
-}
\ No newline at end of file
+}
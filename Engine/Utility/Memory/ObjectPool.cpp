@@ -0,0 +1,93 @@
+#include "Utility/Memory/ObjectPool.h"
+#include "Utility/Memory/Memory.h"
+
+#include <algorithm>
+
+ObjectPool::ObjectPool(size_t _size, size_t _block_size):
+	stride(sizeof(Header) + (std::max(_size, sizeof(Link)) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT),
+	block_size(_block_size), free_list(nullptr), live(0)
+{ }
+
+ObjectPool::~ObjectPool()
+{
+	for (Block &block: blocks)
+		delete[] block.memory;
+}
+
+void *ObjectPool::alloc()
+{
+	std::lock_guard<std::mutex> guard(lock);
+
+	uint8_t *slot;
+	if (free_list)
+	{
+		slot = reinterpret_cast<uint8_t*>(free_list) - sizeof(Header);
+		free_list = free_list->next;
+	}
+	else
+		slot = take(1);
+
+	Header *header = reinterpret_cast<Header*>(slot);
+	header->pool = this;
+	header->live = true;
+
+	live++;
+	return slot + sizeof(Header);
+}
+
+void *ObjectPool::alloc(size_t _count)
+{
+	std::lock_guard<std::mutex> guard(lock);
+
+	// Freed slots are scattered, runs always come from the blocks
+	uint8_t *slots = take(_count);
+	for (size_t i(0); i < _count; i++)
+	{
+		Header *header = reinterpret_cast<Header*>(slots + i * stride);
+		header->pool = this;
+		header->live = true;
+	}
+
+	live += _count;
+	return slots + sizeof(Header);
+}
+
+void ObjectPool::free(void *_object)
+{
+	Header *header = reinterpret_cast<Header*>(static_cast<uint8_t*>(_object) - sizeof(Header));
+	ObjectPool *pool = header->pool;
+
+	std::lock_guard<std::mutex> guard(pool->lock);
+
+	header->live = false;
+
+	Link *link = static_cast<Link*>(_object);
+	link->next = pool->free_list;
+	pool->free_list = link;
+
+	pool->live--;
+}
+
+/// Methods (private)
+uint8_t *ObjectPool::take(size_t _count)
+{
+	if (blocks.empty() || blocks.back().capacity - blocks.back().used < _count)
+	{
+		// The end of the previous block is left unused
+		size_t capacity = std::max(block_size, _count);
+
+		Block block;
+		block.memory = new uint8_t[capacity * stride + ALIGNMENT - 1];
+		block.data = align(block.memory, ALIGNMENT);
+		block.capacity = capacity;
+		block.used = 0;
+
+		blocks.push_back(block);
+	}
+
+	Block &block = blocks.back();
+	uint8_t *slots = block.data + block.used * stride;
+	block.used += _count;
+
+	return slots;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <mutex>
+
+// Thread safe pool of fixed size objects, freed objects are reused before the blocks grow
+// Each slot starts with a header pointing back to its pool, so objects are freed without knowing their pool,
+// and the live objects can be walked in memory order.
+class ObjectPool
+{
+public:
+	static const size_t ALIGNMENT = 16; // of the objects
+
+	ObjectPool(size_t _size, size_t _block_size = 64); // _block_size: objects per block
+	~ObjectPool();
+
+	void *alloc();
+	void *alloc(size_t _count); // _count contiguous objects, getStride() bytes apart
+	static void free(void *_object);
+
+	// Calls _func(void*) on every live object, in memory order
+	// Objects must not be allocated or freed during the walk
+	template <typename F>
+	void each(F _func) const
+	{
+		for (const Block &block: blocks)
+		{
+			for (size_t i(0); i < block.used; i++)
+			{
+				uint8_t *slot = block.data + i * stride;
+				if (reinterpret_cast<Header*>(slot)->live)
+					_func(slot + sizeof(Header));
+			}
+		}
+	}
+
+	size_t getSize() const		{ return live; } // live objects
+	size_t getStride() const	{ return stride; }
+	size_t getBlockCount() const	{ return blocks.size(); }
+
+private:
+	struct alignas(ALIGNMENT) Header
+	{
+		ObjectPool *pool;
+		bool live;
+	};
+
+	struct Block
+	{
+		uint8_t *memory, *data; // data is memory aligned
+		size_t capacity, used; // in objects
+	};
+
+	struct Link
+	{
+		Link *next;
+	};
+
+	uint8_t *take(size_t _count); // _count unused slots, lock held
+
+	const size_t stride, block_size;
+	std::vector<Block> blocks;
+
+	Link *free_list;
+	size_t live;
+	std::mutex lock;
+
+	ObjectPool(const ObjectPool&) = delete;
+	void operator=(const ObjectPool&) = delete;
+};
@@ -4,35 +4,128 @@
 #include <stdint.h>
 #include <vector>
 
+#include "Memory.h"
+
+// Allocates from blocks of block_size bytes, memory is released all at once or back to a marker
+// When a request doesn't fit, the largest tail left in a previous block serves the next smaller ones
+// Allocations bigger than a block get their own heap block, freed with the stack
+// If trim_period is not 0, every trim_period-th clear releases the blocks that were not used since the previous trim
 template <size_t block_size>
 struct StackAllocator
 {
-	StackAllocator(): block(0), index(0)
+	struct Marker
+	{
+		uint32_t block, index;
+		uint32_t spare_block, spare_index;
+		size_t large;
+	};
+
+	// Frees everything allocated during its lifetime
+	struct Scope
+	{
+		Scope(StackAllocator &_allocator):
+			allocator(_allocator), marker(_allocator.getMarker())
+		{ }
+		~Scope() { allocator.freeToMarker(marker); }
+
+		StackAllocator &allocator;
+		Marker marker;
+	};
+
+	StackAllocator(unsigned _trim_period = 0):
+		block(0), index(0), spare_block(0), spare_index(block_size),
+		high_water(0), clears(0), trim_period(_trim_period)
 	{ blocks.push_back(new uint8_t[block_size]); }
 
 	~StackAllocator()
-	{ for (uint8_t *b: blocks) delete[] b;}
+	{
+		for (uint8_t *b: blocks) delete[] b;
+		for (uint8_t *b: large) delete[] b;
+	}
 
-	void *alloc(uint32_t size)
+	void *alloc(size_t size, size_t alignment = 1)
 	{
-		if (index + size <= block_size)
+		size_t start = align(blocks[block] + index, alignment) - blocks[block];
+		if (start + size <= block_size)
+		{
+			index = uint32_t(start + size);
+			return blocks[block] + start;
+		}
+
+		// Too big for any block
+		if (size + alignment - 1 > block_size)
+		{
+			large.push_back(new uint8_t[size + alignment - 1]);
+			return align(large.back(), alignment);
+		}
+
+		// Fits in the spare tail
+		start = align(blocks[spare_block] + spare_index, alignment) - blocks[spare_block];
+		if (start + size <= block_size)
+		{
+			spare_index = uint32_t(start + size);
+			return blocks[spare_block] + start;
+		}
+
+		// Keep the largest tail before moving to the next block
+		if (index < spare_index)
 		{
-			void *data = blocks[block] + index;
-			index += size;
-			return data;
+			spare_block = block;
+			spare_index = index;
 		}
+
 		if (++block == blocks.size())
 			blocks.push_back(new uint8_t[block_size]);
-		index = size;
-		return blocks[block];
+		if (block > high_water)
+			high_water = block;
+
+		start = align(blocks[block], alignment) - blocks[block];
+		index = uint32_t(start + size);
+		return blocks[block] + start;
+	}
+
+	Marker getMarker() const
+	{ return Marker{block, index, spare_block, spare_index, large.size()}; }
+
+	void freeToMarker(const Marker &marker)
+	{
+		block = marker.block;
+		index = marker.index;
+		spare_block = marker.spare_block;
+		spare_index = marker.spare_index;
+
+		while (large.size() > marker.large)
+		{
+			delete[] large.back();
+			large.pop_back();
+		}
 	}
 
 	void clear()
 	{
-		block = 0;
-		index = 0;
+		freeToMarker(Marker{0, 0, 0, block_size, 0});
+
+		if (trim_period && ++clears == trim_period)
+			trim();
+	}
+
+	// Release the blocks after the highest one used since the last trim
+	void trim()
+	{
+		for (size_t i(high_water + 1); i < blocks.size(); i++)
+			delete[] blocks[i];
+		blocks.resize(high_water + 1);
+
+		high_water = block;
+		clears = 0;
 	}
 
 	uint32_t block, index;
 	std::vector<uint8_t*> blocks;
+	std::vector<uint8_t*> large;
+
+private:
+	uint32_t spare_block, spare_index; // tail of a previous block, empty if spare_index is block_size
+	uint32_t high_water;
+	unsigned clears, trim_period;
 };
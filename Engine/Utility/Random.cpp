@@ -1,28 +1,88 @@
 #include "Utility/Random.h"
 
 #include <ctime>
+#include <mutex>
 
-long int Random::seed = 0;
-Random Random::initalizer;
+std::atomic<long int> Random::seed(0);
+std::atomic<unsigned> Random::generation(0);
+thread_local Random::State Random::state = {{0, 0, 0, 0}, ~0u, ~0u};
 
-bool Random::nextBool()
+static std::mutex seed_lock;
+
+// Threads outside of the job system start at this stream
+static std::atomic<unsigned> anonymous_stream(1u << 16);
+
+static uint64_t splitmix64(uint64_t &x)
 {
-	return (double)rand() / RAND_MAX < 0.5;
+	uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
 }
 
-
-Random::Random()
+void Random::fill(float *_values, size_t _count, float _min, float _max)
 {
-	setSeed( static_cast<long int>(time(nullptr)) );
+	const float scale = (_max - _min) * (1.0f / 16777216.0f);
+
+	// Each draw provides two floats
+	size_t i(0);
+	for ( ; i + 1 < _count ; i += 2)
+	{
+		uint64_t bits = next64();
+		_values[i]   = _min + scale * (float)(bits >> 40);
+		_values[i+1] = _min + scale * (float)((bits >> 8) & 0xFFFFFF);
+	}
+
+	if (i < _count)
+		_values[i] = _min + scale * (float)(next64() >> 40);
 }
 
+
 void Random::setSeed(long int _seed)
 {
-	seed = _seed;
-	srand(seed);
+	{
+		std::lock_guard<std::mutex> guard(seed_lock);
+		seed.store(_seed, std::memory_order_relaxed);
+
+		// Force every thread to reseed its stream
+		generation.fetch_add(1, std::memory_order_release);
+	}
+
+	seedThread(state.stream);
 }
 
 long int Random::getSeed()
 {
-	return seed;
+	seedLazily();
+	return seed.load(std::memory_order_relaxed);
+}
+
+void Random::seedThread(unsigned _stream)
+{
+	if (_stream == ~0u)
+		_stream = anonymous_stream.fetch_add(1, std::memory_order_relaxed);
+
+	seedLazily();
+	unsigned current = generation.load(std::memory_order_acquire);
+
+	uint64_t x = (uint64_t)seed.load(std::memory_order_relaxed) ^ ((uint64_t)_stream * 0xD1B54A32D192ED03ull);
+	for (uint64_t& word: state.x)
+		word = splitmix64(x);
+
+	state.generation = current;
+	state.stream = _stream;
+}
+
+// A thread may draw before anyone set a seed, even during static initialization
+void Random::seedLazily()
+{
+	if (generation.load(std::memory_order_acquire) != 0)
+		return;
+
+	std::lock_guard<std::mutex> guard(seed_lock);
+	if (generation.load(std::memory_order_relaxed) == 0)
+	{
+		seed.store(static_cast<long int>(time(nullptr)), std::memory_order_relaxed);
+		generation.store(1, std::memory_order_release);
+	}
 }
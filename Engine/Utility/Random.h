@@ -2,27 +2,37 @@
 
 #include <initializer_list>
 #include <type_traits>
+#include <cstdint>
 #include <cstdlib>
+#include <atomic>
 #include <vector>
 
 
+// xoshiro256** generator with one state per thread
+// Every thread draws from its own stream, derived from the global seed and the thread stream index
+// If no seed was set before the first draw, the time is used
 class Random
 {
 	public:
-		static bool nextBool();
+		static bool nextBool()
+		{
+			return next64() >> 63;
+		}
 
 		template <typename T>
 		static typename std::enable_if<!std::is_integral<T>::value, T>::type next(T _min = 0, T _max = 1) // range is [_min, _max[
 		{
-			return _min +  (_max-_min) * (T)rand() / RAND_MAX;
+			return _min + (_max-_min) * unit<T>();
 		}
 
 		template <typename T>
 		static typename std::enable_if<std::is_integral<T>::value, T>::type next(T _min = 0, T _max = 2) // range is [_min, _max[
 		{
-			return _min + (rand() % (_max-_min));
+			return _min + (T)(next64() % (uint64_t)(_max-_min));
 		}
 
+		static void fill(float *_values, size_t _count, float _min = 0.0f, float _max = 1.0f);
+
 
 		template <typename T>
 		static const T& element(std::initializer_list<T> _elements)
@@ -46,9 +56,58 @@ class Random
 		static void setSeed(long int _seed);
 		static long int getSeed();
 
+		// Bind the calling thread to a stream, threads that never call it get a unique stream on first use
+		static void seedThread(unsigned _stream);
+
+		static uint64_t next64()
+		{
+			State& s = state;
+			if (s.generation != generation.load(std::memory_order_relaxed))
+				seedThread(s.stream);
+
+			const uint64_t result = rotl(s.x[1] * 5, 7) * 9;
+			const uint64_t t = s.x[1] << 17;
+
+			s.x[2] ^= s.x[0];
+			s.x[3] ^= s.x[1];
+			s.x[1] ^= s.x[2];
+			s.x[0] ^= s.x[3];
+
+			s.x[2] ^= t;
+			s.x[3] = rotl(s.x[3], 45);
+
+			return result;
+		}
+
 	private:
-		static long int seed;
-		static Random initalizer;
+		struct State
+		{
+			uint64_t x[4];
+			unsigned generation, stream;
+		};
 
-		Random();
+		static inline uint64_t rotl(uint64_t x, int k)
+		{
+			return (x << k) | (x >> (64 - k));
+		}
+
+		template <typename T>
+		static T unit() // range is [0, 1[
+		{
+			return (T)(next64() >> 11) * (T)(1.0 / 9007199254740992.0);
+		}
+
+		static void seedLazily();
+
+		static std::atomic<long int> seed;
+		static std::atomic<unsigned> generation; // 0 until a seed is set
+		static thread_local State state;
+
+		Random() = delete;
 };
+
+template <>
+inline float Random::unit<float>()
+{
+	return (float)(next64() >> 40) * (1.0f / 16777216.0f);
+}
@@ -1,6 +1,7 @@
 #include "Tag.h"
 
 std::vector< std::string > Tag::tags = { "Untagged", "MainCamera" };
+std::unordered_map< std::string, int > Tag::ids = { {"Untagged", 0}, {"MainCamera", 1} };
 
 Tag::Tag(const char* _tag):
 	Tag(std::string(_tag))
@@ -34,12 +35,12 @@ bool Tag::operator==(const Tag& _tag) const
 
 bool Tag::operator==(const char* _tag) const
 {
-	return (tag == getTag(_tag));
+	return (tag == findTag(_tag));
 }
 
 bool Tag::operator==(const std::string& _tag) const
 {
-	return (tag == getTag(_tag));
+	return (tag == findTag(_tag));
 }
 
 
@@ -51,17 +52,24 @@ bool Tag::operator!=(const Tag& _tag) const
 
 int Tag::getTag(const std::string& _tag)
 {
-	auto it = std::find(tags.begin(), tags.end(), _tag);
+	auto it = ids.find(_tag);
 
-	if ( it != tags.end() )
-	   return it - tags.begin();
+	if ( it != ids.end() )
+		return it->second;
 	else
 	{
 		tags.push_back(_tag);
+		ids.emplace(_tag, tags.size()-1);
 		return tags.size()-1;
 	}
 }
 
+int Tag::findTag(const std::string& _tag)
+{
+	auto it = ids.find(_tag);
+	return (it != ids.end()) ? it->second : -1;
+}
+
 std::ostream& operator<<(std::ostream& os, const Tag& tag)
 {
 	return os << tag.toString();
@@ -18,11 +18,16 @@ class Tag
 		bool operator!=(const Tag& _tag) const;
 
 		std::string toString() const;
+		int getId() const	{ return tag; } // dense, starts at 0
+
+		static int getCount()	{ return tags.size(); }
 
 	private:
 		static int getTag(const std::string& _tag);
+		static int findTag(const std::string& _tag); // -1 if the tag doesn't exist
 
 		static std::vector< std::string > tags;
+		static std::unordered_map< std::string, int > ids;
 
 		int tag;
 };
@@ -7,6 +7,7 @@
 #include <string>
 
 #include <unordered_map>
+#include <algorithm>
 #include <vector>
 
 #include "Utility/glm.h"
@@ -52,3 +53,12 @@ bool epsilonEqual(const quat& a, const quat& b, float epsilon = EPSILON);
 
 
 void simd_mul(const mat4& a, const mat4& b, mat4& out);
+
+// Make room for _count more elements, growing geometrically
+template <typename T>
+void reserveMore(std::vector<T>& _vector, size_t _count)
+{
+	size_t needed = _vector.size() + _count;
+	if (needed > _vector.capacity())
+		_vector.reserve(std::max(needed, 2 * _vector.capacity()));
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct Result
+{
+	std::string name;
+	unsigned workers;
+	uint64_t ops;
+	double total_ms;
+	double ns_per_op;
+};
+
+class Bench
+{
+public:
+	// Time the best of several runs of func, each run performing ops operations
+	template <typename F>
+	static void measure(const std::string &name, unsigned workers, uint64_t ops, F func, unsigned runs = 5)
+	{
+		double best = 0.0;
+		for (unsigned i(0); i < runs; i++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			func();
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+			if (i == 0 || elapsed.count() < best)
+				best = elapsed.count();
+		}
+
+		results.push_back({name, workers, ops, best, best * 1e6 / (double)ops});
+	}
+
+	// Record a value that isn't a timing
+	static void count(const std::string &name, uint64_t value)
+	{
+		counters.push_back({name, value});
+	}
+
+	static bool write(const char *path);
+
+	static std::vector<Result> results;
+	static std::vector<std::pair<std::string, uint64_t>> counters;
+
+	// Calls to the global operator new while counting is set
+	static std::atomic<bool> counting;
+	static std::atomic<uint64_t> allocations;
+};
+
+void bench_jobsystem(unsigned max_workers);
+void bench_pool();
+void bench_frame(unsigned max_workers);
@@ -0,0 +1,99 @@
+#include "bench.h"
+
+#include "Utility/JobSystem/JobSystem.inl"
+#include "Utility/Memory/FrameAllocator.h"
+
+// Model of the transient allocations of a render frame: per object command lists, then a parallel sort
+// It doesn't run the engine (no scene, scripts, physics or GL), so its allocation count only covers
+// the FrameAllocator and the JobSystem, not a real Engine::update
+
+struct Pair
+{
+	uint64_t key;
+	void *packet;
+
+	bool operator<(const Pair &other) const
+	{ return key < other.key; }
+};
+
+struct frame_data
+{
+	FrameAllocator *frames;
+	std::atomic<uint64_t> *count;
+};
+
+// Like Graphic::render: a few transient arrays per object
+void frame_job(const void *_data)
+{
+	auto *data = static_cast<const JobSystem::ParallelFor<uint32_t, frame_data>*>(_data);
+	FrameAllocator *frames = data->user_data.frames;
+
+	uint64_t count = 0;
+	for (uint32_t *it = data->start; it != data->end; ++it)
+	{
+		FrameVector<void*> commands{FrameSTLAllocator<void*>(frames)};
+		for (uint32_t i(0); i < 1 + *it % 4; i++)
+			commands.push_back(frames->alloc<Pair>(1));
+
+		count += commands.size();
+	}
+
+	data->user_data.count->fetch_add(count, std::memory_order_relaxed);
+}
+
+// Like GraphicEngine::submit: gather, then sort the commands of the frame
+void run_frame(FrameAllocator &frames, std::vector<uint32_t> &objects)
+{
+	frames.flip();
+	JobSystem::reset_arena();
+
+	std::atomic<uint64_t> count(0);
+	JobSystem::ParallelFor<uint32_t, frame_data> data{objects.data(), (unsigned)objects.size(), &frames, &count};
+
+	std::atomic<int> counter(0);
+	int jobs = JobSystem::parallel_for(frame_job, &data, &counter);
+	JobSystem::wait(&counter, jobs);
+
+	unsigned pair_count = (unsigned)count.load();
+	Pair *pairs = frames.alloc<Pair>(pair_count);
+	Pair *buffer = frames.alloc<Pair>(pair_count);
+
+	for (unsigned i(0); i < pair_count; i++)
+		pairs[i] = {(uint64_t)(i * 2654435761u), nullptr};
+
+	JobSystem::parallel_sort(pairs, pair_count, buffer);
+}
+
+void bench_frame(unsigned max_workers)
+{
+	const unsigned count = 20000, frames_count = 100;
+
+	JobSystem::Config config;
+	config.worker_count = max_workers;
+	JobSystem::init(config);
+
+	std::vector<uint32_t> objects(count);
+	for (unsigned i(0); i < count; i++)
+		objects[i] = i;
+
+	{
+		FrameAllocator frames(4 << 20);
+
+		// Warm up, then count allocations in steady state
+		for (unsigned i(0); i < 10; i++)
+			run_frame(frames, objects);
+
+		Bench::allocations = 0;
+		Bench::measure("frame model", max_workers, frames_count, [&]() {
+			Bench::counting = true;
+			for (unsigned i(0); i < frames_count; i++)
+				run_frame(frames, objects);
+			Bench::counting = false;
+		}, 1);
+
+		Bench::count("frame model heap allocations", Bench::allocations.load());
+		Bench::count("frame model overflows", frames.getOverflow());
+	}
+
+	JobSystem::destroy();
+}
@@ -0,0 +1,125 @@
+#include "bench.h"
+
+#include "Utility/JobSystem/JobSystem.inl"
+#include "Utility/Random.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+void empty_job(const void*) {}
+
+struct scale_data
+{
+	float factor;
+};
+
+void scale_job(const void *_data)
+{
+	auto *data = static_cast<const JobSystem::ParallelFor<float, scale_data>*>(_data);
+
+	for (float *it = data->start; it != data->end; ++it)
+		*it = std::sqrt(*it) * data->user_data.factor;
+}
+
+void init(unsigned workers)
+{
+	JobSystem::Config config;
+	config.worker_count = workers;
+	JobSystem::init(config);
+}
+
+void bench_queue(unsigned workers)
+{
+	const unsigned count = 100000;
+
+	// Owner push then pop
+	Bench::measure("push pop", workers, count, [&]() {
+		std::atomic<int> counter(0);
+		for (unsigned i(0); i < count; i++)
+			JobSystem::run(empty_job, nullptr, 0, &counter);
+		JobSystem::wait(&counter, count);
+	});
+
+	// Every job executes on another worker
+	if (workers > 1)
+	{
+		Bench::measure("steal", workers, count, [&]() {
+			std::atomic<int> counter(0);
+			for (unsigned i(0); i < count; i++)
+				JobSystem::run(empty_job, nullptr, 0, &counter);
+			while (counter.load(std::memory_order_relaxed) != (int)count)
+				std::this_thread::yield();
+		});
+	}
+
+	// A single job from run to wait returning
+	Bench::measure("wait latency", workers, count / 10, [&]() {
+		for (unsigned i(0); i < count / 10; i++)
+		{
+			std::atomic<int> counter(0);
+			JobSystem::run(empty_job, nullptr, 0, &counter);
+			JobSystem::wait(&counter, 1);
+		}
+	});
+}
+
+void bench_parallel_for(unsigned workers)
+{
+	const unsigned count = 1 << 22;
+	std::vector<float> values(count, 1.0f);
+
+	Bench::measure("parallel_for", workers, count, [&]() {
+		JobSystem::ParallelFor<float, scale_data> data{values.data(), count, 1.0001f};
+
+		std::atomic<int> counter(0);
+		int jobs = JobSystem::parallel_for(scale_job, &data, &counter);
+		JobSystem::wait(&counter, jobs);
+	});
+}
+
+void bench_primitives(unsigned workers)
+{
+	const unsigned count = 1 << 22;
+
+	Random::setSeed(42);
+	std::vector<uint64_t> source(count), values(count), buffer(count);
+	for (uint64_t &value: source)
+		value = Random::next64();
+
+	auto sum = [](uint64_t a, uint64_t b) { return a + b; };
+
+	Bench::measure("parallel_reduce", workers, count, [&]() {
+		volatile uint64_t total = JobSystem::parallel_reduce(source.data(), count, (uint64_t)0, sum);
+		(void)total;
+	});
+
+	Bench::measure("parallel_scan", workers, count, [&]() {
+		JobSystem::parallel_scan(source.data(), values.data(), count, (uint64_t)0, sum);
+	});
+
+	// Copy is included in both sort timings
+	Bench::measure("std::sort", workers, count, [&]() {
+		std::copy(source.begin(), source.end(), values.begin());
+		std::sort(values.begin(), values.end());
+	});
+
+	Bench::measure("parallel_sort", workers, count, [&]() {
+		std::copy(source.begin(), source.end(), values.begin());
+		JobSystem::parallel_sort(values.data(), count, buffer.data());
+	});
+}
+
+void bench_jobsystem(unsigned max_workers)
+{
+	for (unsigned workers(1); workers <= max_workers; workers++)
+	{
+		init(workers);
+
+		bench_queue(workers);
+		bench_parallel_for(workers);
+		bench_primitives(workers);
+
+		JobSystem::destroy();
+	}
+}
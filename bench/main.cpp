@@ -0,0 +1,74 @@
+#include "bench.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+std::vector<Result> Bench::results;
+std::vector<std::pair<std::string, uint64_t>> Bench::counters;
+
+std::atomic<bool> Bench::counting(false);
+std::atomic<uint64_t> Bench::allocations(0);
+
+void *operator new(size_t size)
+{
+	if (Bench::counting.load(std::memory_order_relaxed))
+		Bench::allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void *data = malloc(size ? size : 1))
+		return data;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *data) noexcept
+{
+	free(data);
+}
+
+void operator delete(void *data, size_t) noexcept
+{
+	free(data);
+}
+
+bool Bench::write(const char *path)
+{
+	FILE *file = path ? fopen(path, "w") : stdout;
+	if (file == nullptr)
+		return false;
+
+	fprintf(file, "{\n\t\"hardware_concurrency\": %u,\n\t\"results\": [", std::thread::hardware_concurrency());
+	for (size_t i(0); i < results.size(); i++)
+	{
+		const Result &r = results[i];
+		fprintf(file, "%s\n\t\t{\"name\": \"%s\", \"workers\": %u, \"ops\": %llu, \"total_ms\": %.3f, \"ns_per_op\": %.3f}",
+			i ? "," : "", r.name.c_str(), r.workers, (unsigned long long)r.ops, r.total_ms, r.ns_per_op);
+	}
+	fprintf(file, "\n\t],\n\t\"counters\": {");
+	for (size_t i(0); i < counters.size(); i++)
+		fprintf(file, "%s\n\t\t\"%s\": %llu", i ? "," : "", counters[i].first.c_str(), (unsigned long long)counters[i].second);
+	fprintf(file, "\n\t}\n}\n");
+
+	return file == stdout || fclose(file) == 0;
+}
+
+// usage: bench [output.json] [max workers]
+int main(int argc, char **argv)
+{
+	const char *output = argc > 1 ? argv[1] : nullptr;
+
+	unsigned max_workers = argc > 2 ? (unsigned)atoi(argv[2]) : std::thread::hardware_concurrency();
+	if (max_workers == 0) max_workers = 1;
+
+	bench_jobsystem(max_workers);
+	bench_pool();
+	bench_frame(max_workers);
+
+	if (!Bench::write(output))
+	{
+		fprintf(stderr, "Failed to write results to %s\n", output);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
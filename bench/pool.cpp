@@ -0,0 +1,142 @@
+#include "bench.h"
+
+#include "Components/Component.h"
+#include "Utility/Random.h"
+
+// Stand-ins for components of different sizes, created interleaved like entities are
+template <size_t floats>
+struct Dummy : public Component
+{
+	Dummy() { for (float &f: data) f = 1.0f; }
+	Component* cloneInto(void*) const override { return nullptr; }
+
+	float update() { data[0] += 1.0f; return data[0]; }
+
+	float data[floats];
+};
+
+// How a world allocates its components
+enum Source
+{
+	HEAP,		// global operator new, as before pools
+	SIZE_POOL,	// Component::operator new, like a plain new of a component
+	TYPE_POOL	// pool of the type, like Entity::insert
+};
+
+template <size_t floats>
+Dummy<floats>* create(Source source)
+{
+	if (source == HEAP)
+		return ::new Dummy<floats>();
+	if (source == SIZE_POOL)
+		return new Dummy<floats>();
+	return new (Component::getPool(ComponentType::id<Dummy<floats>>(), sizeof(Dummy<floats>))) Dummy<floats>();
+}
+
+struct World
+{
+	World(Source _source, unsigned count): source(_source)
+	{
+		first.reserve(count);
+		others.reserve(2 * count);
+		removed.reserve(count);
+	}
+
+	// Interleaved creations with some churn, the first type is the one iterated
+	void populate(unsigned count)
+	{
+		for (unsigned i(0); i < count; i++)
+		{
+			first.push_back(create<4>(source));
+			others.push_back(create<12>(source));
+			others.push_back(create<24>(source));
+
+			if (Random::next<unsigned>(0, 4) == 0)
+				removed.push_back(create<4>(source));
+		}
+
+		for (Component *c: removed)
+			destroy(c);
+		removed.clear();
+	}
+
+	void clear()
+	{
+		for (Component *c: first) destroy(c);
+		for (Component *c: others) destroy(c);
+
+		first.clear();
+		others.clear();
+	}
+
+	void destroy(Component *c)
+	{
+		if (source == HEAP)
+			::delete c;
+		else
+			delete c;
+	}
+
+	float iterate()
+	{
+		float sum = 0.0f;
+		for (Dummy<4> *d: first)
+			sum += d->update();
+		return sum;
+	}
+
+	Source source;
+	std::vector<Dummy<4>*> first;
+	std::vector<Component*> others, removed;
+};
+
+void bench_world(const char *name, Source source, unsigned count)
+{
+	World world(source, count);
+
+	// Heap requests to create the world the first time, pools are kept after that
+	Bench::allocations = 0;
+	Bench::counting = true;
+	world.populate(count);
+	Bench::counting = false;
+
+	Bench::count(std::string(name) + " allocations", Bench::allocations.load());
+	world.clear();
+
+	std::string prefix(name);
+	Bench::measure(prefix + " create destroy", 1, count * 3, [&]() {
+		world.populate(count);
+		world.clear();
+	});
+
+	world.populate(count);
+
+	volatile float sink = 0.0f;
+	Bench::measure(prefix + " iterate", 1, count * 10, [&]() {
+		for (unsigned i(0); i < 10; i++)
+			sink = sink + world.iterate();
+	});
+
+	if (source == TYPE_POOL)
+	{
+		Bench::measure(prefix + " walk", 1, count * 10, [&]() {
+			for (unsigned i(0); i < 10; i++)
+			{
+				float sum = 0.0f;
+				Component::eachInPool<Dummy<4>>([&](Dummy<4> *d) { sum += d->update(); });
+				sink = sink + sum;
+			}
+		});
+	}
+
+	world.clear();
+}
+
+void bench_pool()
+{
+	const unsigned count = 200000;
+
+	bench_world("heap", HEAP, count);
+	bench_world("size pool", SIZE_POOL, count);
+	bench_world("type pool", TYPE_POOL, count);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <atomic>
+
+// Self-checking target: every failed CHECK is reported, main returns the failure count
+class Check
+{
+public:
+	static bool expect(bool condition, const char *expr, const char *file, int line)
+	{
+		if (!condition)
+		{
+			fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+			failures++;
+		}
+		return condition;
+	}
+
+	static unsigned failures;
+
+	// Calls to the global operator new while counting is set
+	static std::atomic<bool> counting;
+	static std::atomic<uint64_t> allocations;
+};
+
+#define CHECK(expr) Check::expect((expr), #expr, __FILE__, __LINE__)
+
+void check_jobsystem();
+void check_memory();
+void check_snapshot();
+void check_frame();
@@ -0,0 +1,82 @@
+#include "check.h"
+
+#include "Engine.h"
+#include "Entity.h"
+#include "Components/RigidBody.h"
+#include "Components/Box.h"
+
+#include "Renderer/RenderContext.inl"
+#include "Utility/JobSystem/JobSystem.inl"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Records a draw command per key in the context of the worker, like GraphicEngine::prepare
+static void record_cmd(const void *_data)
+{
+	auto *data = static_cast<const JobSystem::ParallelFor<uint64_t, RenderContext*>*>(_data);
+	RenderContext *ctx = data->user_data + JobSystem::worker_id();
+
+	for (uint64_t *it = data->start; it != data->end; ++it)
+		ctx->add(*it, ctx->create<DrawElements>());
+}
+
+// Steady state frames of a headless engine don't allocate from the heap
+// Crates resting on a floor keep the physics solving contacts every step, then commands are sorted
+void check_frame()
+{
+	Engine *engine = new Engine(nullptr);
+
+	Entity::create("Floor", false, vec3(0.0f))
+		->insert<RigidBody>(0.0f)
+		->insert<Box>(vec3(10.0f, 10.0f, 0.5f));
+
+	for (int i(0); i < 16; i++)
+	{
+		Entity::create("Crate", false, vec3(i % 4 * 1.5f, i / 4 * 1.5f, 1.0f))
+			->insert<RigidBody>(1.0f)
+			->insert<Box>(vec3(0.5f));
+	}
+
+	unsigned workers = JobSystem::worker_count();
+	RenderContext *contexts = new RenderContext[workers];
+
+	std::vector<uint64_t> keys(4096);
+	for (size_t i(0); i < keys.size(); i++)
+		keys[i] = (i * 2654435761u) % 65521;
+
+	bool sorted = true;
+	auto frame = [&]() {
+		// About one physics step per frame
+		std::this_thread::sleep_for(std::chrono::milliseconds(17));
+
+		Check::counting = true;
+		engine->update();
+
+		JobSystem::ParallelFor<uint64_t, RenderContext*> data{keys.data(), (unsigned)keys.size(), contexts};
+		std::atomic<int> counter(0);
+		JobSystem::wait(&counter, JobSystem::parallel_for(record_cmd, &data, &counter));
+
+		size_t count;
+		RenderContext::CommandPair *pairs = RenderContext::sort(contexts, workers, count);
+		Check::counting = false;
+
+		sorted &= count == keys.size() && std::is_sorted(pairs, pairs + count);
+	};
+
+	// Pools, frame memory, contact storage and the scheduler graph reach their size
+	for (int i(0); i < 60; i++)
+		frame();
+
+	Check::allocations = 0;
+	for (int i(0); i < 30; i++)
+		frame();
+
+	CHECK(sorted);
+	CHECK(Check::allocations == 0);
+
+	delete[] contexts;
+	delete engine;
+}
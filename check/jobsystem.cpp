@@ -0,0 +1,89 @@
+#include "check.h"
+
+#include "Utility/JobSystem/JobSystem.inl"
+#include "Utility/Random.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+// Sizes around the grains of reduce and scan (1024) and sort (4096)
+static const unsigned sizes[] = {0, 1, 2, 1023, 1024, 1025, 4095, 4097, 10007, 100003};
+
+void check_reduce(const std::vector<uint64_t> &values)
+{
+	unsigned count = (unsigned)values.size();
+
+	uint64_t sum = JobSystem::parallel_reduce(values.data(), count, uint64_t(0), std::plus<uint64_t>());
+	CHECK(sum == std::accumulate(values.begin(), values.end(), uint64_t(0)));
+
+	auto max = [](uint64_t a, uint64_t b) { return std::max(a, b); };
+	uint64_t largest = JobSystem::parallel_reduce(values.data(), count, uint64_t(0), max);
+	CHECK(largest == (count ? *std::max_element(values.begin(), values.end()) : 0));
+}
+
+void check_scan(const std::vector<uint64_t> &values)
+{
+	unsigned count = (unsigned)values.size();
+
+	std::vector<uint64_t> expected(count);
+	uint64_t acc = 0;
+	for (unsigned i(0); i < count; i++)
+	{
+		expected[i] = acc;
+		acc += values[i];
+	}
+
+	std::vector<uint64_t> out(count);
+	uint64_t total = JobSystem::parallel_scan(values.data(), out.data(), count, uint64_t(0), std::plus<uint64_t>());
+	CHECK(total == acc);
+	CHECK(out == expected);
+
+	// In place
+	out = values;
+	total = JobSystem::parallel_scan(out.data(), out.data(), count, uint64_t(0), std::plus<uint64_t>());
+	CHECK(total == acc);
+	CHECK(out == expected);
+}
+
+void check_sort(const std::vector<uint64_t> &values)
+{
+	unsigned count = (unsigned)values.size();
+
+	std::vector<uint64_t> expected = values;
+	std::sort(expected.begin(), expected.end());
+
+	std::vector<uint64_t> data = values;
+	JobSystem::parallel_sort(data.data(), count);
+	CHECK(data == expected);
+
+	// With a buffer and a custom comparison
+	std::vector<uint64_t> buffer(count);
+	data = values;
+	JobSystem::parallel_sort(data.data(), count, buffer.data(), std::greater<uint64_t>());
+	CHECK(std::equal(data.begin(), data.end(), expected.rbegin()));
+}
+
+void check_jobsystem()
+{
+	for (unsigned workers: {1u, 2u, 5u})
+	{
+		JobSystem::Config config;
+		config.worker_count = workers;
+		JobSystem::init(config);
+
+		for (unsigned count: sizes)
+		{
+			std::vector<uint64_t> values(count);
+			for (uint64_t &value: values)
+				value = Random::next<uint64_t>(0, 1000);
+
+			check_reduce(values);
+			check_scan(values);
+			check_sort(values);
+		}
+
+		JobSystem::destroy();
+	}
+}
@@ -0,0 +1,46 @@
+#include "check.h"
+
+#include <cstdlib>
+#include <new>
+
+unsigned Check::failures = 0;
+
+std::atomic<bool> Check::counting(false);
+std::atomic<uint64_t> Check::allocations(0);
+
+void *operator new(size_t size)
+{
+	if (Check::counting.load(std::memory_order_relaxed))
+		Check::allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void *data = malloc(size ? size : 1))
+		return data;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *data) noexcept
+{
+	free(data);
+}
+
+void operator delete(void *data, size_t) noexcept
+{
+	free(data);
+}
+
+int main()
+{
+	check_jobsystem();
+	check_memory();
+	check_snapshot();
+	check_frame();
+
+	if (Check::failures)
+	{
+		fprintf(stderr, "%u checks failed\n", Check::failures);
+		return EXIT_FAILURE;
+	}
+
+	printf("All checks passed\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+#include "check.h"
+
+#include "Utility/Memory/BlockAllocator.h"
+
+void check_stack()
+{
+	StackAllocator<64> stack;
+
+	// 48 bytes leave a tail of 16, the next 56 go to a new block
+	uint8_t *first = (uint8_t*)stack.alloc(48);
+	uint8_t *second = (uint8_t*)stack.alloc(56);
+	CHECK(stack.block == 1);
+
+	// Smaller requests that don't fit the current block go to the tail of the first one
+	StackAllocator<64>::Marker marker = stack.getMarker();
+	CHECK(stack.alloc(16) == first + 48);
+	CHECK(stack.alloc(8) == second + 56);
+
+	// Both are full
+	stack.alloc(8);
+	CHECK(stack.block == 2);
+
+	// Rolling back gives the tail back, aligned requests use it too
+	stack.freeToMarker(marker);
+	CHECK(stack.alloc(16, 16) == first + 48);
+	CHECK(stack.block == 1);
+
+	stack.clear();
+	CHECK(stack.alloc(48) == first);
+	CHECK(stack.alloc(56) == second);
+	CHECK(stack.alloc(16) == first + 48);
+
+	// Too big for a block
+	void *large = stack.alloc(128);
+	CHECK(large != nullptr && stack.large.size() == 1);
+	stack.clear();
+	CHECK(stack.large.empty());
+}
+
+void check_blocks()
+{
+	BlockAllocator<4, uint64_t> blocks;
+
+	for (uint64_t i(0); i < 10; i++)
+		*blocks.alloc() = i;
+	CHECK(blocks.count() == 10);
+
+	// Elements are stored in order
+	uint64_t expected = 0;
+	for (auto it = blocks.first(); it.data; blocks.next(it))
+		CHECK(*it.data == expected++);
+	CHECK(expected == 10);
+}
+
+void check_memory()
+{
+	check_stack();
+	check_blocks();
+}
@@ -0,0 +1,92 @@
+#include "check.h"
+
+#include "Snapshot.h"
+#include "Components/Transform.h"
+#include "Components/RigidBody.h"
+#include "Components/Light.h"
+#include "Components/Box.h"
+#include "Components/Sphere.h"
+#include "Components/Cylinder.h"
+#include "Components/Cone.h"
+
+#include <cstdio>
+#include <vector>
+
+static std::vector<uint8_t> read_file(const char *path)
+{
+	std::vector<uint8_t> data;
+	if (FILE *file = fopen(path, "rb"))
+	{
+		uint8_t buffer[4096];
+		size_t n;
+		while ((n = fread(buffer, 1, sizeof(buffer), file)) != 0)
+			data.insert(data.end(), buffer, buffer + n);
+		fclose(file);
+	}
+	return data;
+}
+
+// Save, load and save again a scaled hierarchy of prototypes
+// Prototype components are not registered and have no transform, so no engine is needed
+void check_snapshot()
+{
+	const char *path = "check_snapshot.bin";
+
+	Entity *crate = Entity::create("Crate", true, vec3(1.0f, 2.0f, 3.0f), vec3(0.0f), vec3(2.0f, 3.0f, 4.0f))
+		->insert<RigidBody>(2.0f)
+		->insert<Box>(vec3(0.5f, 1.0f, 1.5f), vec3(0.0f, 1.0f, 0.0f), nullptr, true)
+		->insert<Light>(Light::Spot, vec3(1.0f, 0.5f, 0.25f), true);
+
+	Entity *wheel = Entity::create("Wheel", true, vec3(0.0f), vec3(0.0f), vec3(3.0f))
+		->insert<Sphere>(0.25f)
+		->insert<Cylinder>(0.5f, 2.0f)
+		->insert<Cone>(1.0f, 3.0f, vec3(0.0f, 0.0f, 1.0f));
+
+	wheel->find<Transform>()->setParent(crate->find<Transform>());
+
+	CHECK(Snapshot::save(path));
+	std::vector<uint8_t> saved = read_file(path);
+	CHECK(!saved.empty());
+
+	Entity::clear();
+
+	std::vector<Entity*> loaded = Snapshot::load(path);
+	if (CHECK(loaded.size() == 2))
+	{
+		Entity *c = loaded[0], *w = loaded[1];
+
+		CHECK(c->prototype && w->prototype);
+		CHECK(c->getTag() == "Crate" && w->getTag() == "Wheel");
+
+		Transform *tr = c->find<Transform>();
+		CHECK(tr->position == vec3(1.0f, 2.0f, 3.0f));
+		CHECK(tr->scale == vec3(2.0f, 3.0f, 4.0f));
+		CHECK(w->find<Transform>()->getParent() == tr);
+
+		Box *box = c->find<Box>();
+		if (CHECK(box != nullptr))
+			CHECK(box->getCenter() == vec3(0.0f, 1.0f, 0.0f) && box->getTrigger());
+
+		// Loaded components come from the pool of their type
+		size_t boxes = 0;
+		Component::eachInPool<Box>([&](Box *b) { boxes += b == box; });
+		CHECK(boxes == 1);
+
+		Light *light = c->find<Light>();
+		if (CHECK(light != nullptr))
+		{
+			CHECK(light->getLightType() == Light::Spot);
+			CHECK(light->getColor() == vec3(1.0f, 0.5f, 0.25f) && light->getCastShadow());
+		}
+
+		CHECK(c->find<RigidBody>() != nullptr);
+		CHECK(w->find<Sphere>() && w->find<Cylinder>() && w->find<Cone>());
+
+		// Shapes are saved unscaled, a second save gives the same file
+		CHECK(Snapshot::save(path));
+		CHECK(read_file(path) == saved);
+	}
+
+	Entity::clear();
+	remove(path);
+}
@@ -150,3 +150,116 @@ project "test"
 		defines "NDEBUG"
 		optimize "speed"
 
+
+project "bench"
+	targetname "bench_%{cfg.buildcfg}"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++14"
+	staticruntime "on"
+
+	targetdir ("bin")
+	objdir ("obj")
+	debugdir ("bin")
+
+	-- Sources (headless, only the engine parts that don't need a window)
+	files {
+		"%{prj.name}/**.h",
+		"%{prj.name}/**.cpp",
+		"Engine/Utility/JobSystem/**",
+		"Engine/Utility/Memory/**",
+		"Engine/Utility/Random.*",
+		"Engine/Utility/Error.*",
+		"Engine/Components/Component.*",
+		"Engine/ComponentType.*"
+	}
+
+	includedirs { "Engine" }
+
+	-- Component headers include SFML and glm, only their headers are needed
+	filter "system:windows"
+		includedirs {
+			sfml_path .. "/include",
+			glm_path
+		}
+
+	-- Libraries
+	filter "system:linux"
+		links { "pthread" }
+
+	-- Defines and flags
+	filter "system:windows"
+		systemversion "latest"
+		defines "_CRT_SECURE_NO_DEPRECATE"
+
+	filter "configurations:debug"
+		defines "DEBUG"
+		symbols "on"
+		optimize "off"
+
+	filter "configurations:dev"
+		defines "DEBUG"
+		optimize "debug"
+
+	filter "configurations:release"
+		defines "NDEBUG"
+		optimize "speed"
+
+project "check"
+	targetname "check_%{cfg.buildcfg}"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++14"
+	staticruntime "on"
+
+	targetdir ("bin")
+	objdir ("obj")
+	debugdir ("bin")
+
+	-- Sources (headless, no window is opened)
+	files {
+		"%{prj.name}/**.h",
+		"%{prj.name}/**.cpp"
+	}
+
+	includedirs { "Engine" }
+
+	filter "system:windows"
+		includedirs {
+			sfml_path .. "/include",
+			glew_path .. "/include",
+			glm_path
+		}
+
+	filter {} -- Reset filters
+
+	-- Libraries
+	links { "Engine" }
+
+	filter "system:linux"
+		links {
+			"GL", "GLEW", "pthread",
+			"sfml-audio",
+			"sfml-graphics",
+			"sfml-window",
+			"sfml-network",
+			"sfml-system"
+		}
+
+	-- Defines and flags
+	filter "system:windows"
+		systemversion "latest"
+		defines "_CRT_SECURE_NO_DEPRECATE"
+
+	filter "configurations:debug"
+		defines "DEBUG"
+		symbols "on"
+		optimize "off"
+
+	filter "configurations:dev"
+		defines "DEBUG"
+		optimize "debug"
+
+	filter "configurations:release"
+		defines "NDEBUG"
+		optimize "speed"
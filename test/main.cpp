@@ -75,6 +75,9 @@ int main()
 		if (Input::getKeyReleased(sf::Keyboard::F3))
 			PhysicEngine::get()->setGravity();
 
+		if (Input::getKeyReleased(sf::Keyboard::F4))
+			engine->setPipelined(!engine->getPipelined());
+
 
 		if (Input::getKeyReleased(sf::Keyboard::Tab))
 		{
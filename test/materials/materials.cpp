@@ -24,12 +24,13 @@ void test_materials()
 		mats[i]->set("roughness_map", Texture::get(mat_names[i] + "/roughness.png"));
 	}
 
+	std::vector<Entity::Placement> placements;
 	for (int i(0); i < 41; i++)
 	for (int j(0); j < 21; j++)
-	{
-		auto e = Entity::clone(object, vec3(0.0f, i-20.0f, j-10.0f), vec3(0.0f), vec3(0.5f));
+		placements.push_back({vec3(0.0f, i-20.0f, j-10.0f), quat(vec3(0.0f)), vec3(0.5f)});
+
+	for (Entity* e: Entity::instantiate(object, placements.size(), placements.data()))
 		e->find<Graphic>()->setMesh(mesh, {mats[Random::next<int>(0, mat_names.size())]});
-	}
 
 	// Camera
 	Entity::create("MainCamera", false, vec3(-15.0f, 0.0f, 0.0f))